@@ -88,6 +88,13 @@ public class BaseCppTest implements RuntimeTestSupport {
 	/** Errors found while running antlr */
 	protected StringBuilder antlrToolErrors;
 
+	/** Additional options for generating the parser, like -DexceptionFree=true */
+	protected final String[] extraParserOptions;
+
+	public BaseCppTest(String... extraParserOptions) {
+		this.extraParserOptions = extraParserOptions;
+	}
+
 	private String getPropertyPrefix() {
 		return "antlr-" + getLanguage().toLowerCase();
 	}
@@ -387,11 +394,14 @@ public class BaseCppTest implements RuntimeTestSupport {
 	                         String input,
 	                         boolean showDiagnosticErrors)
 	{
+		List<String> options = new ArrayList<String>();
+		options.add("-visitor");
+		options.addAll(Arrays.asList(extraParserOptions));
 		boolean success = rawGenerateAndBuildRecognizer(grammarFileName,
 		                                                grammarStr,
 		                                                parserName,
 		                                                lexerName,
-		                                                "-visitor");
+		                                                options.toArray(new String[options.size()]));
 		assertTrue(success);
 		writeFile(tmpdir, "input", input);
 		rawBuildRecognizerTestFile(parserName,
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+package org.antlr.v4.test.runtime.cpp;
+
+import org.antlr.v4.test.runtime.BaseParserTestDescriptor;
+import org.antlr.v4.test.runtime.BaseRuntimeTest;
+import org.antlr.v4.test.runtime.CommentHasStringValue;
+import org.antlr.v4.test.runtime.RuntimeTestDescriptor;
+import org.antlr.v4.test.runtime.category.ParserTests;
+import org.junit.experimental.categories.Category;
+import org.junit.runner.RunWith;
+import org.junit.runners.Parameterized;
+
+/** The generated context accessors select children by the rule index (Rule&lt;name&gt; constants of the parser)
+ *  and token type stored in the nodes. These tests use rule names with underscores, digits and a trailing
+ *  underscore, alt labels (contexts copied with copyFrom()) and left recursion (contexts pushed with
+ *  pushNewRecursionContext()). Rule names which are C++ keywords are rejected by the tool, so they never
+ *  reach the generated accessors.
+ */
+@Category(ParserTests.class)
+@RunWith(Parameterized.class)
+public class TestContextAccessors extends BaseRuntimeTest {
+	public TestContextAccessors(RuntimeTestDescriptor descriptor) {
+		super(descriptor,new BaseCppTest());
+	}
+
+	@Parameterized.Parameters(name="{0}")
+	public static RuntimeTestDescriptor[] getAllTestDescriptors() {
+		return BaseRuntimeTest.getRuntimeTestDescriptors(TestContextAccessors.class, "Cpp");
+	}
+
+	public static abstract class ContextAccessorTestDescriptor extends BaseParserTestDescriptor {
+		public String errors = null;
+		public String startRule = "file";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 @parser::definitions {
+		 static std::string describe(TParser::ExprContext *e) {
+		   if (auto add = dynamic_cast\<TParser::AddContext *>(e)) {
+		     return "(" + describe(add->expr(0)) + " + " + describe(add->expr(1)) + ")";
+		   }
+		   if (auto mul = dynamic_cast\<TParser::MulContext *>(e)) {
+		     return "(" + describe(mul->expr(0)) + " * " + describe(mul->expr(1)) + ")";
+		   }
+		   if (auto var = dynamic_cast\<TParser::VarContext *>(e)) {
+		     return var->ID()->getText();
+		   }
+		   return static_cast\<TParser::LiteralContext *>(e)->literal_()->INT()->getText();
+		 }
+
+		 static void print(TParser::ItemContext *item, const std::string &indent) {
+		   if (item->stat_a() != nullptr) {
+		     std::string names;
+		     for (auto id : item->stat_a()->ID()) {
+		       names += (names.empty() ? "" : ", ") + id->getText();
+		     }
+		     std::cout \<\< indent \<\< names \<\< " = " \<\< describe(item->stat_a()->expr()) \<\< std::endl;
+		   } else {
+		     std::cout \<\< indent \<\< "block with " \<\< item->block2()->item().size() \<\< " items" \<\< std::endl;
+		     for (size_t i = 0; i \< item->block2()->item().size(); ++i) {
+		       print(item->block2()->item(i), indent + "  ");
+		     }
+		   }
+		 }
+		 }
+		 file : item* EOF
+		      {
+		      for (auto item : $ctx->item()) {
+		        print(item, "");
+		      }
+		      }
+		      ;
+		 item : stat_a | block2 ;
+		 stat_a : ID (',' ID)* '=' expr ';' ;
+		 block2 : '{' item* '}' ;
+		 expr : expr '*' expr  # Mul
+		      | expr '+' expr  # Add
+		      | ID             # Var
+		      | literal_       # Literal
+		      ;
+		 literal_ : INT ;
+		 ID : [a-z]+ ;
+		 INT : [0-9]+ ;
+		 WS : [ \t\r\n]+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+	}
+
+	public static class Statements extends ContextAccessorTestDescriptor {
+		public String input = "a = 1;\nb, c = a + 2 * c;\nd = a * b + 3;\n";
+		public String output =
+			"a = 1\n" +
+			"b, c = (a + (2 * c))\n" +
+			"d = ((a * b) + 3)\n";
+	}
+
+	public static class NestedBlocks extends ContextAccessorTestDescriptor {
+		public String input = "a = 1;\n{ b = a; { } { c, d = 2; } }\ne = b;\n";
+		public String output =
+			"a = 1\n" +
+			"block with 3 items\n" +
+			"  b = a\n" +
+			"  block with 0 items\n" +
+			"  block with 1 items\n" +
+			"    c, d = 2\n" +
+			"e = b\n";
+	}
+}
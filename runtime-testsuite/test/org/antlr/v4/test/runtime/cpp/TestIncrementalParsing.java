@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+package org.antlr.v4.test.runtime.cpp;
+
+import org.antlr.v4.test.runtime.BaseParserTestDescriptor;
+import org.antlr.v4.test.runtime.BaseRuntimeTest;
+import org.antlr.v4.test.runtime.CommentHasStringValue;
+import org.antlr.v4.test.runtime.RuntimeTestDescriptor;
+import org.antlr.v4.test.runtime.category.ParserTests;
+import org.junit.experimental.categories.Category;
+import org.junit.runner.RunWith;
+import org.junit.runners.Parameterized;
+import org.stringtemplate.v4.ST;
+
+/** Reparses edited inputs with parsers generated with the incremental option and compares the trees with those
+ *  of a full parse. The versions of the input are separated by lines with "---".
+ */
+@Category(ParserTests.class)
+@RunWith(Parameterized.class)
+public class TestIncrementalParsing extends BaseRuntimeTest {
+	public TestIncrementalParsing(RuntimeTestDescriptor descriptor) {
+		super(descriptor,new IncrementalCppTest());
+	}
+
+	@Parameterized.Parameters(name="{0}")
+	public static RuntimeTestDescriptor[] getAllTestDescriptors() {
+		return BaseRuntimeTest.getRuntimeTestDescriptors(TestIncrementalParsing.class, "Cpp");
+	}
+
+	/** Writes a test program which parses the first version of the input and reparses each following one
+	 *  incrementally. It prints each tree, followed by the tree of a full parse if that is different.
+	 */
+	public static class IncrementalCppTest extends BaseCppTest {
+		public IncrementalCppTest() {
+			super("-Dincremental=true");
+		}
+
+		@Override
+		protected void writeParserTestFile(String parserName, String lexerName,
+		                                   String listenerName, String visitorName,
+		                                   String parserStartRuleName, boolean debug, boolean trace) {
+			if(!parserStartRuleName.endsWith(")"))
+				parserStartRuleName += "()";
+			ST outputFileST = new ST(
+				"#include \\<fstream>\n"
+					+ "#include \\<iostream>\n"
+					+ "\n"
+					+ "#include \"antlr4-runtime.h\"\n"
+					+ "#include \"<lexerName>.h\"\n"
+					+ "#include \"<parserName>.h\"\n"
+					+ "\n"
+					+ "using namespace antlr4;\n"
+					+ "\n"
+					+ "std::string parseFully(const std::string &text) {\n"
+					+ "  ANTLRInputStream input(text);\n"
+					+ "  <lexerName> lexer(&input);\n"
+					+ "  CommonTokenStream tokens(&lexer);\n"
+					+ "  <parserName> parser(&tokens);\n"
+					+ "  return parser.<parserStartRuleName>->toStringTree(&parser);\n"
+					+ "}\n"
+					+ "\n"
+					+ "int main(int argc, const char* argv[]) {\n"
+					+ "  std::ifstream stream(argv[1]);\n"
+					+ "  std::string text((std::istreambuf_iterator\\<char>(stream)), std::istreambuf_iterator\\<char>());\n"
+					+ "  std::vector\\<std::string> versions;\n"
+					+ "  for (size_t start = 0; start \\<= text.size();) {\n"
+					+ "    size_t end = text.find(\"---\\n\", start);\n"
+					+ "    versions.push_back(text.substr(start, end == std::string::npos ? std::string::npos : end - start));\n"
+					+ "    start = end == std::string::npos ? text.size() + 1 : end + 4;\n"
+					+ "  }\n"
+					+ "\n"
+					+ "  ANTLRInputStream input(versions[0]);\n"
+					+ "  <lexerName> lexer(&input);\n"
+					+ "  IncrementalLexer incrementalLexer(&lexer);\n"
+					+ "  incrementalLexer.lexAll();\n"
+					+ "  std::vector\\<std::unique_ptr\\<Token>> copies;\n"
+					+ "  for (auto &token : incrementalLexer.getTokens()) {\n"
+					+ "    copies.emplace_back(new CommonToken(token.get()));\n"
+					+ "  }\n"
+					+ "  ListTokenSource source(std::move(copies));\n"
+					+ "  std::unique_ptr\\<IncrementalTokenStream> tokens(new IncrementalTokenStream(&source));\n"
+					+ "  <parserName> parser(tokens.get());\n"
+					+ "  ParserRuleContext *tree = parser.<parserStartRuleName>;\n"
+					+ "  std::cout \\<\\< tree->toStringTree(&parser) \\<\\< std::endl;\n"
+					+ "\n"
+					+ "  for (size_t i = 1; i \\< versions.size(); ++i) {\n"
+					+ "    // The inputs are ASCII, so bytes are code points.\n"
+					+ "    const std::string &previous = versions[i - 1];\n"
+					+ "    const std::string &current = versions[i];\n"
+					+ "    size_t prefix = 0;\n"
+					+ "    while (prefix \\< previous.size() && prefix \\< current.size() && previous[prefix] == current[prefix]) {\n"
+					+ "      ++prefix;\n"
+					+ "    }\n"
+					+ "    size_t suffix = 0;\n"
+					+ "    while (suffix \\< previous.size() - prefix && suffix \\< current.size() - prefix\n"
+					+ "           && previous[previous.size() - 1 - suffix] == current[current.size() - 1 - suffix]) {\n"
+					+ "      ++suffix;\n"
+					+ "    }\n"
+					+ "\n"
+					+ "    input.load(current);\n"
+					+ "    IncrementalLexer::TokenChange change = incrementalLexer.relex(prefix, previous.size() - prefix - suffix,\n"
+					+ "      current.size() - prefix - suffix);\n"
+					+ "    std::unique_ptr\\<IncrementalTokenStream> newTokens(\n"
+					+ "      new IncrementalTokenStream(*tokens, incrementalLexer.getTokens(), change));\n"
+					+ "    parser.setReparseInput(newTokens.get(), tree, change);\n"
+					+ "    tree = parser.<parserStartRuleName>;\n"
+					+ "    tokens = std::move(newTokens);\n"
+					+ "\n"
+					+ "    std::string reparsed = tree->toStringTree(&parser);\n"
+					+ "    std::cout \\<\\< reparsed \\<\\< std::endl;\n"
+					+ "    if (parser.getReusedContextCount() == 0) {\n"
+					+ "      std::cout \\<\\< \"nothing reused\" \\<\\< std::endl;\n"
+					+ "    }\n"
+					+ "    std::string full = parseFully(current);\n"
+					+ "    if (reparsed != full) {\n"
+					+ "      std::cout \\<\\< \"full parse: \" \\<\\< full \\<\\< std::endl;\n"
+					+ "    }\n"
+					+ "  }\n"
+					+ "\n"
+					+ "  return 0;\n"
+					+ "}\n"
+			);
+			outputFileST.add("parserName", parserName);
+			outputFileST.add("lexerName", lexerName);
+			outputFileST.add("parserStartRuleName", parserStartRuleName);
+			writeFile(tmpdir, "Test.cpp", outputFileST.render());
+		}
+	}
+
+	public static abstract class IncrementalParserTestDescriptor extends BaseParserTestDescriptor {
+		public String errors = null;
+		public String startRule = "file";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 file : stat* EOF ;
+		 stat : ID '=' expr ';'
+		      | '{' stat* '}'
+		      ;
+		 expr : expr '*' expr
+		      | expr '+' expr
+		      | '(' expr ')'
+		      | ID
+		      | INT
+		      ;
+		 ID : [a-z]+ ;
+		 INT : [0-9]+ ;
+		 WS : [ \t\r\n]+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+	}
+
+	public static class ChangeToken extends IncrementalParserTestDescriptor {
+		public String input =
+			"a = 1;\n{ b = a + 2; c = (b); }\nd = c * 3;\n" +
+			"---\n" +
+			"a = 1;\n{ b = a + 22; c = (b); }\nd = c * 3;\n";
+		public String output =
+			"(file (stat a = (expr 1) ;) (stat { (stat b = (expr (expr a) + (expr 2)) ;) (stat c = (expr ( (expr b) )) ;) }) (stat d = (expr (expr c) * (expr 3)) ;) <EOF>)\n" +
+			"(file (stat a = (expr 1) ;) (stat { (stat b = (expr (expr a) + (expr 22)) ;) (stat c = (expr ( (expr b) )) ;) }) (stat d = (expr (expr c) * (expr 3)) ;) <EOF>)\n";
+	}
+
+	public static class InsertAndRemoveStatements extends IncrementalParserTestDescriptor {
+		public String input =
+			"a = 1;\n{ b = a + 2; c = (b); }\nd = c * 3;\n" +
+			"---\n" +
+			"a = 1;\n{ b = a + 2; }\nd = c * 3;\n" +
+			"---\n" +
+			"a = 1;\n{ b = a + 2; }\nx = 5;\nd = c * 3;\n" +
+			"---\n" +
+			"{ b = a + 2; }\nx = 5;\nd = c * 3;\n" +
+			"---\n" +
+			"{ b = a + 2; }\nx = 5;\nd = c * 3;\ne = d;\n";
+		public String output =
+			"(file (stat a = (expr 1) ;) (stat { (stat b = (expr (expr a) + (expr 2)) ;) (stat c = (expr ( (expr b) )) ;) }) (stat d = (expr (expr c) * (expr 3)) ;) <EOF>)\n" +
+			"(file (stat a = (expr 1) ;) (stat { (stat b = (expr (expr a) + (expr 2)) ;) }) (stat d = (expr (expr c) * (expr 3)) ;) <EOF>)\n" +
+			"(file (stat a = (expr 1) ;) (stat { (stat b = (expr (expr a) + (expr 2)) ;) }) (stat x = (expr 5) ;) (stat d = (expr (expr c) * (expr 3)) ;) <EOF>)\n" +
+			"(file (stat { (stat b = (expr (expr a) + (expr 2)) ;) }) (stat x = (expr 5) ;) (stat d = (expr (expr c) * (expr 3)) ;) <EOF>)\n" +
+			"(file (stat { (stat b = (expr (expr a) + (expr 2)) ;) }) (stat x = (expr 5) ;) (stat d = (expr (expr c) * (expr 3)) ;) (stat e = (expr d) ;) <EOF>)\n";
+	}
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+package org.antlr.v4.test.runtime.cpp;
+
+import org.antlr.v4.test.runtime.BaseRuntimeTest;
+import org.antlr.v4.test.runtime.RuntimeTestDescriptor;
+import org.antlr.v4.test.runtime.category.ParserTests;
+import org.antlr.v4.test.runtime.descriptors.ParserErrorsDescriptors;
+import org.junit.experimental.categories.Category;
+import org.junit.runner.RunWith;
+import org.junit.runners.Parameterized;
+
+/** Runs the parser error tests with parsers generated with the exceptionFree option, which must give the same output. */
+@Category(ParserTests.class)
+@RunWith(Parameterized.class)
+public class TestParserErrorsExceptionFree extends BaseRuntimeTest {
+	public TestParserErrorsExceptionFree(RuntimeTestDescriptor descriptor) {
+		super(descriptor,new BaseCppTest("-DexceptionFree=true"));
+	}
+
+	@Parameterized.Parameters(name="{0}")
+	public static RuntimeTestDescriptor[] getAllTestDescriptors() {
+		return BaseRuntimeTest.getRuntimeTestDescriptors(ParserErrorsDescriptors.class, "Cpp");
+	}
+}
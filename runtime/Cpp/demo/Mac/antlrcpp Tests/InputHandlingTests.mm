@@ -32,13 +32,46 @@
 #include "ANTLRInputStream.h"
 #include "Exceptions.h"
 #include "Interval.h"
+#include "UnbufferedCharStream.h"
 #include "UnbufferedTokenStream.h"
+#include "SlidingWindowTokenStream.h"
+#include "CommonToken.h"
 #include "StringUtils.h"
 
+#include "TLexer.h"
+#include "TParser.h"
+
 using namespace antlrcpp;
 using namespace antlr4;
 using namespace antlr4::misc;
 
+// A token which counts its instances, to see which tokens a token stream still holds.
+class CountedToken : public CommonToken {
+public:
+  static size_t instances;
+
+  CountedToken(Token *token) : CommonToken(token) {
+    ++instances;
+  }
+
+  virtual ~CountedToken() {
+    --instances;
+  }
+};
+
+size_t CountedToken::instances = 0;
+
+class CountingLexer : public antlrcpptest::TLexer {
+public:
+  CountingLexer(CharStream *input) : TLexer(input) {
+  }
+
+  virtual std::unique_ptr<Token> nextToken() override {
+    std::unique_ptr<Token> token = TLexer::nextToken();
+    return std::unique_ptr<Token>(new CountedToken(token.get()));
+  }
+};
+
 @interface InputHandlingTests : XCTestCase
 
 @end
@@ -165,6 +198,254 @@ using namespace antlr4::misc;
   XCTAssertEqual(stream.getSourceName(), "unit tests");
 }
 
+- (void)testANTLRInputStreamWidths {
+  // The stream stores the input with 1, 2 or 4 bytes per code point, depending on the largest code point.
+  std::vector<std::u32string> texts = {
+    U"plain ASCII text",
+    U"Latin-1: Grüße, ½ ÿ",
+    U"BMP: Ωμέγα 中文 \uFFFD",
+    U"Astral: 🚧 𝄞 \U0010FFFF end"
+  };
+
+  ANTLRInputStream reused;
+  for (auto &text : texts) {
+    std::string utf8 = utf32_to_utf8(text);
+    ANTLRInputStream stream(utf8);
+    XCTAssertEqual(stream.size(), text.size());
+    XCTAssertEqual(stream.toString(), utf8);
+    XCTAssertEqual(stream.LA(-1), IntStream::EOF);
+
+    for (size_t i = 0; i < text.size(); ++i) {
+      XCTAssertEqual(stream.LA(1), static_cast<size_t>(text[i]));
+      if (i > 0) {
+        XCTAssertEqual(stream.LA(-1), static_cast<size_t>(text[i - 1]));
+      }
+      stream.consume();
+    }
+    XCTAssertEqual(stream.LA(1), IntStream::EOF);
+    XCTAssertEqual(stream.LA(-1), static_cast<size_t>(text.back()));
+
+    std::string middle = utf32_to_utf8(text.substr(3, 10));
+    XCTAssertEqual(stream.getText(misc::Interval(3, 12UL)), middle);
+
+    // Copies and reloaded streams read the new data with the matching width.
+    ANTLRInputStream copy = stream;
+    copy.seek(0);
+    XCTAssertEqual(copy.LA(2), static_cast<size_t>(text[1]));
+    reused.load(utf8);
+    XCTAssertEqual(reused.size(), text.size());
+    XCTAssertEqual(reused.LA(text.size()), static_cast<size_t>(text.back()));
+    XCTAssertEqual(reused.LA(text.size() + 1), IntStream::EOF);
+  }
+
+  reused.load("");
+  XCTAssertEqual(reused.size(), 0U);
+  XCTAssertEqual(reused.LA(1), IntStream::EOF);
+}
+
+// Builds text which mixes characters of the given utf-8 lengths in (pseudo) random order, so that sequences cross
+// the block boundaries of the vectorized decoder in every possible position.
+static std::u32string mixedText(size_t count, std::vector<size_t> const& lengths, uint32_t seed) {
+  static const char32_t samples[][4] = {
+    { U'a', U'Z', U'0', U' ' },
+    { 0xE4, 0xFF, 0x3A9, 0x44F }, // ä, ÿ, Ω, я
+    { 0x800, 0x4E2D, 0xD7FF, 0xFFFD },
+    { 0x10000, 0x1F6A7, 0x1F576, 0x10FFFF }
+  };
+
+  std::u32string result;
+  for (size_t i = 0; i < count; ++i) {
+    seed = seed * 1103515245 + 12345;
+    size_t length = lengths[(seed >> 16) % lengths.size()];
+    result += samples[length - 1][(seed >> 8) % 4];
+  }
+  return result;
+}
+
+- (void)testUtf8Conversion {
+  std::string text(u8"Grüße, Ωμέγα, Кириллица, 中文字符, 🚧🕶 and plain ASCII to finish it off.");
+  std::u32string expected(U"Grüße, Ωμέγα, Кириллица, 中文字符, 🚧🕶 and plain ASCII to finish it off.");
+  XCTAssert(utf8_to_utf32(text.c_str(), text.c_str() + text.size()) == expected);
+  XCTAssertEqual(utf32_to_utf8(expected), text);
+
+  // All combinations of sequence lengths, long enough for the vector paths.
+  std::vector<std::vector<size_t>> combinations = {
+    { 1 }, { 2 }, { 3 }, { 4 }, { 1, 2 }, { 1, 3 }, { 2, 3 }, { 1, 2, 3 }, { 1, 2, 3, 4 }
+  };
+  for (size_t seed = 0; seed < 20; ++seed) {
+    for (auto &lengths : combinations) {
+      std::u32string original = mixedText(100 + seed, lengths, static_cast<uint32_t>(seed));
+      std::string encoded = utf32_to_utf8(original);
+
+      UTF32String decoded;
+      size_t errorOffset = 0;
+      XCTAssert(utf8_to_utf32(encoded.c_str(), encoded.c_str() + encoded.size(), decoded, errorOffset));
+      XCTAssert(decoded == original);
+
+      std::u16string ucs2;
+      bool narrow = lengths.back() < 4;
+      XCTAssertEqual(utf8_to_ucs2(encoded.c_str(), encoded.c_str() + encoded.size(), ucs2, errorOffset), narrow);
+      if (narrow) {
+        XCTAssert(std::u32string(ucs2.begin(), ucs2.end()) == original);
+        XCTAssertEqual(ucs2_to_utf8(ucs2.data(), ucs2.data() + ucs2.size()), encoded);
+      }
+    }
+  }
+
+  // Latin-1 only accepts 2 byte sequences up to U+00FF.
+  std::string latin1;
+  size_t errorOffset = 0;
+  text = u8"Grüße aus Köln, ça va très bien, déjà vu, smörgåsbord";
+  XCTAssert(utf8_to_latin1(text.c_str(), text.c_str() + text.size(), latin1, errorOffset));
+  XCTAssertEqual(latin1.size(), 53U);
+  XCTAssertEqual(latin1_to_utf8(latin1.c_str(), latin1.c_str() + latin1.size()), text);
+
+  text = u8"Grüße aus Köln, ça va très bien, Ωμέγα";
+  XCTAssertFalse(utf8_to_latin1(text.c_str(), text.c_str() + text.size(), latin1, errorOffset));
+  XCTAssertEqual(errorOffset, text.find(u8"Ω"));
+  XCTAssertEqual(latin1.size(), 33U);
+}
+
+- (void)testUtf8InvalidInput {
+  std::string prefix(u8"Ωμέγα 中文 abcdefgh");
+  std::vector<std::string> invalid = {
+    "\x80", // Stray continuation byte.
+    "\xC3", // Lead without continuation.
+    "\xC0\xAF", // Overlong 2 byte form.
+    "\xE0\x80\xAF", // Overlong 3 byte form.
+    "\xED\xA0\x80", // Surrogate.
+    "\xF4\x90\x80\x80", // Beyond U+10FFFF.
+    "\xFF"
+  };
+
+  for (auto &sequence : invalid) {
+    // Place the error in all positions of a vector block and follow it with enough valid input for the vector path.
+    for (size_t padding = 0; padding < 16; ++padding) {
+      std::string text = prefix + std::string(padding, 'x') + sequence + u8"ÄÖÜäöüß中文字符 and more";
+      UTF32String result;
+      size_t errorOffset = 0;
+      XCTAssertFalse(utf8_to_utf32(text.c_str(), text.c_str() + text.size(), result, errorOffset));
+      XCTAssertEqual(errorOffset, prefix.size() + padding);
+      XCTAssertEqual(result.size(), 17 + padding);
+    }
+  }
+
+  std::string text = "abc\xE4\xB8";
+  XCTAssertThrows(utf8_to_utf32(text.c_str(), text.c_str() + text.size()));
+}
+
+- (void)testUtf8DecodingPerformance {
+  std::string text = utf32_to_utf8(mixedText(1000000, { 1, 1, 1, 1, 2, 3 }, 42));
+  [self measureBlock:^{
+    std::u32string result = utf8_to_utf32(text.c_str(), text.c_str() + text.size());
+    XCTAssertEqual(result.size(), 1000000U);
+  }];
+}
+
+- (void)testUnbufferedCharStream {
+  std::stringstream input("abcdefghijklmnopqrstuvwxyz");
+  UnbufferedCharStream stream(input);
+  XCTAssertEqual(stream.LA(1), U'a');
+  XCTAssertEqual(stream.LA(-1), IntStream::EOF);
+
+  // Releasing the marker leaves the consumed chars in the buffer (less than half of it is consumed), so a new marker
+  // must not take the current char as the one before the buffer start.
+  ssize_t marker = stream.mark();
+  stream.consume();
+  stream.consume();
+  stream.release(marker);
+  marker = stream.mark();
+  XCTAssertEqual(stream.LA(-1), U'b');
+  stream.seek(0);
+  XCTAssertEqual(stream.index(), 0U);
+  XCTAssertEqual(stream.LA(1), U'a');
+  XCTAssertEqual(stream.LA(-1), IntStream::EOF);
+
+  stream.seek(2);
+  XCTAssertEqual(stream.LA(-1), U'b');
+  XCTAssertEqual(stream.LA(1), U'c');
+  stream.release(marker);
+
+  // Consuming past the middle of the buffer compacts it on release, seeking before the buffer start then fails.
+  marker = stream.mark();
+  for (size_t i = 0; i < 20; ++i) {
+    stream.consume();
+  }
+  stream.release(marker);
+  marker = stream.mark();
+  XCTAssertEqual(stream.LA(-1), U'v');
+  XCTAssertEqual(stream.LA(1), U'w');
+  XCTAssertThrows(stream.seek(0));
+  stream.consume();
+  stream.seek(22);
+  XCTAssertEqual(stream.LA(-1), U'v');
+  stream.release(marker);
+
+  XCTAssertEqual(stream.getText(misc::Interval(22, 24UL)), "wxy");
+}
+
+- (void)testSlidingWindowTokenStream {
+  std::string text;
+  for (size_t i = 0; i < 2000; ++i) {
+    text += "value" + std::to_string(i) + " = 1 + b * (c + 2);\n";
+  }
+
+  // Parse without a parse tree: only the current segments stay in memory, all other tokens are freed.
+  {
+    ANTLRInputStream input(text);
+    CountingLexer lexer(&input);
+    SlidingWindowTokenStream tokens(&lexer, Token::DEFAULT_CHANNEL, 64);
+    antlrcpptest::TParser parser(&tokens);
+    parser.setBuildParseTree(false);
+    parser.main();
+
+    XCTAssertEqual(parser.getNumberOfSyntaxErrors(), 0U);
+    XCTAssertEqual(tokens.LA(1), Token::EOF);
+    XCTAssertGreaterThan(tokens.getWindowStart(), 20000U);
+    XCTAssertLessThan(tokens.getWindowSize(), 128U);
+    XCTAssertEqual(CountedToken::instances, tokens.getWindowSize());
+  }
+  XCTAssertEqual(CountedToken::instances, 0U);
+
+  // Tokens at and after the retained index stay available, also for look back.
+  ANTLRInputStream input(text);
+  CountingLexer lexer(&input);
+  SlidingWindowTokenStream tokens(&lexer, Token::DEFAULT_CHANNEL, 16);
+  tokens.setRetainedIndex(0);
+  std::vector<std::string> consumed;
+  for (size_t i = 0; i < 300; ++i) {
+    consumed.push_back(tokens.LT(1)->getText());
+    tokens.consume();
+  }
+  XCTAssertEqual(tokens.getWindowStart(), 0U);
+  for (size_t i = 1; i <= consumed.size(); ++i) {
+    XCTAssertEqual(tokens.LT(-static_cast<ssize_t>(i))->getText(), consumed[consumed.size() - i]);
+  }
+  XCTAssertEqual(tokens.LT(-300)->getText(), consumed[0]);
+  XCTAssert(tokens.LT(-301) == nullptr);
+
+  tokens.setRetainedIndex(100);
+  XCTAssertEqual(tokens.getWindowStart(), 96U); // Discarded in full segments only.
+  XCTAssertEqual(tokens.get(100)->getTokenIndex(), 100U);
+  XCTAssertThrows(tokens.get(95));
+  XCTAssertEqual(CountedToken::instances, tokens.getWindowSize());
+
+  size_t lookBack = 0; // The on-channel tokens from index 96 on.
+  while (tokens.LT(-static_cast<ssize_t>(lookBack + 1)) != nullptr) {
+    Token *token = tokens.LT(-static_cast<ssize_t>(lookBack + 1));
+    XCTAssertEqual(token->getText(), consumed[consumed.size() - lookBack - 1]);
+    ++lookBack;
+  }
+  XCTAssertLessThan(lookBack, consumed.size());
+  XCTAssertGreaterThan(lookBack, 100U);
+
+  // Without a retained index only the segment with LT(-1) remains.
+  tokens.setRetainedIndex(INVALID_INDEX);
+  XCTAssertEqual(tokens.LT(-1)->getText(), consumed.back());
+  XCTAssertLessThanOrEqual(tokens.index() - tokens.getWindowStart(), 32U);
+  XCTAssertEqual(CountedToken::instances, tokens.getWindowSize());
+}
+
 - (void)testUnbufferedTokenSteam {
   //UnbufferedTokenStream stream;
 }
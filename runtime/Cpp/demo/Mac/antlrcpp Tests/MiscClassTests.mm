@@ -35,6 +35,77 @@ using namespace antlr4;
 using namespace antlr4::misc;
 using namespace antlrcpp;
 
+// Heap accounting for the memory tests below. Every allocation carries its size in front of the returned memory.
+static std::atomic<size_t> allocatedBytes(0);
+static std::atomic<size_t> allocationCount(0);
+
+void* operator new(size_t size) {
+  void *memory = malloc(size + 16);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  allocatedBytes += size;
+  ++allocationCount;
+  *static_cast<size_t *>(memory) = size;
+  return static_cast<char *>(memory) + 16;
+}
+
+void operator delete(void *p) noexcept {
+  if (p != nullptr) {
+    char *memory = static_cast<char *>(p) - 16;
+    allocatedBytes -= *reinterpret_cast<size_t *>(memory);
+    free(memory);
+  }
+}
+
+// Builds a tree of the given size through the tracker: rule contexts with 1 - 5 children, of which ~45% are rule
+// contexts again and the rest terminals. Returns the root and the number of rule contexts in rules.
+static ParserRuleContext* buildTree(tree::ParseTreeTracker &tracker, size_t nodeCount, size_t &rules) {
+  ParserRuleContext *root = tracker.createInstance<ParserRuleContext>();
+  std::deque<ParserRuleContext *> pending = { root };
+  rules = 1;
+  uint32_t seed = 1;
+  for (size_t count = 1; count < nodeCount && !pending.empty();) {
+    ParserRuleContext *rule = pending.front();
+    pending.pop_front();
+
+    seed = seed * 1103515245 + 12345;
+    size_t childCount = 1 + (seed >> 16) % 5;
+    for (size_t i = 0; i < childCount && count < nodeCount; ++i, ++count) {
+      seed = seed * 1103515245 + 12345;
+      tree::ParseTree *child;
+      if ((seed >> 16) % 100 < 45 || pending.empty()) {
+        ParserRuleContext *context = tracker.createInstance<ParserRuleContext>(rule, 0);
+        pending.push_back(context);
+        child = context;
+        ++rules;
+      } else {
+        child = tracker.createInstance<tree::TerminalNodeImpl>(nullptr);
+      }
+      child->parent = rule;
+      rule->children.push_back(child);
+    }
+  }
+  return root;
+}
+
+// Counts the terminals of a tree, with scalar results in antlrcpp::Any.
+class TerminalCounter : public tree::AbstractParseTreeVisitor {
+public:
+  virtual antlrcpp::Any visitTerminal(tree::TerminalNode * /*node*/) override {
+    return static_cast<size_t>(1);
+  }
+
+protected:
+  virtual antlrcpp::Any defaultResult() override {
+    return static_cast<size_t>(0);
+  }
+
+  virtual antlrcpp::Any aggregateResult(antlrcpp::Any aggregate, const antlrcpp::Any &nextResult) override {
+    return aggregate.as<size_t>() + nextResult.as<size_t>();
+  }
+};
+
 @interface MiscClassTests : XCTestCase
 
 @end
@@ -51,6 +122,127 @@ using namespace antlrcpp;
   [super tearDown];
 }
 
+- (void)testParseTreeMemory {
+  const size_t nodeCount = 200000;
+  size_t before = allocatedBytes;
+  {
+    tree::ParseTreeTracker tracker;
+    size_t rules;
+    buildTree(tracker, nodeCount, rules);
+    XCTAssert(rules > nodeCount * 4 / 10 && rules < nodeCount / 2);
+
+    // With std::vector children (80 byte rule contexts, 64 byte terminals) the same tree took 92 bytes per node.
+    // ChildList must save at least 15% of that.
+    double bytesPerNode = static_cast<double>(allocatedBytes - before) / nodeCount;
+    XCTAssertLessThan(bytesPerNode, 92 * 0.85);
+  }
+  XCTAssertEqual(allocatedBytes, before);
+}
+
+- (void)testAny {
+  struct Position {
+    int line;
+    int column;
+  };
+
+  struct Payload {
+    int values[8];
+    ~Payload() {} // Not trivially copyable.
+  };
+
+  // Small trivially copyable values are stored inline.
+  size_t allocations = allocationCount;
+  Any number = 42;
+  Any pointer = &allocations;
+  Any position = Position { 3, 14 };
+  Any flag = true;
+  XCTAssert(number.is<int>());
+  XCTAssertFalse(number.is<long>());
+  XCTAssertEqual(number.as<int>(), 42);
+  XCTAssertEqual(pointer.as<size_t *>(), &allocations);
+  XCTAssertEqual(position.as<Position>().column, 14);
+  XCTAssert(flag.as<bool>());
+  XCTAssertThrows(number.as<std::string>());
+
+  Any copy = number;
+  copy.as<int>() = 7;
+  XCTAssertEqual(number.as<int>(), 42);
+  XCTAssertEqual(copy.as<int>(), 7);
+  Any moved = std::move(position);
+  XCTAssert(position.isNull());
+  XCTAssertEqual(moved.as<Position>().line, 3);
+  XCTAssertEqual(allocationCount, allocations);
+
+  // Everything else goes to the heap. Copies are deep, moves transfer the value.
+  size_t before = allocatedBytes;
+  {
+    Any payload = Payload { { 1, 2, 3, 4, 5, 6, 7, 8 } };
+    XCTAssert(payload.is<Payload>());
+    XCTAssertEqual(allocationCount, allocations + 1);
+
+    Any payloadCopy = payload;
+    payloadCopy.as<Payload>().values[0] = 10;
+    XCTAssertEqual(payload.as<Payload>().values[0], 1);
+    XCTAssertEqual(payloadCopy.as<Payload>().values[0], 10);
+    XCTAssertEqual(allocationCount, allocations + 2);
+
+    allocations = allocationCount;
+    Any payloadMoved = std::move(payload);
+    XCTAssert(payload.isNull());
+    XCTAssertEqual(payloadMoved.as<Payload>().values[7], 8);
+    XCTAssertEqual(allocationCount, allocations);
+
+    // Copy assignment (copy-and-swap) between inline, heap and null values.
+    Any value = 1.5;
+    value = payloadCopy;
+    XCTAssertEqual(value.as<Payload>().values[0], 10);
+    value = value;
+    XCTAssertEqual(value.as<Payload>().values[0], 10);
+    value = number;
+    XCTAssertEqual(value.as<int>(), 42);
+    value = payloadMoved;
+    value = Any();
+    XCTAssert(value.isNull());
+    XCTAssertEqual(payloadMoved.as<Payload>().values[0], 1);
+
+    // Move assignment swaps the values.
+    value = std::move(payloadMoved);
+    XCTAssertEqual(value.as<Payload>().values[1], 2);
+    XCTAssert(payloadMoved.isNull());
+    Any seven = 7;
+    value = std::move(seven);
+    XCTAssertEqual(value.as<int>(), 7);
+
+    // Values which could throw when copied are not copied.
+    Any text = std::string(100, 'x');
+    XCTAssertEqual(text.as<std::string>().size(), 100U);
+    Any textCopy = text;
+    XCTAssert(textCopy.isNull());
+  }
+  XCTAssertEqual(allocatedBytes, before);
+
+  Any nothing = nullptr;
+  XCTAssert(nothing.isNull());
+  XCTAssertThrows(nothing.as<int>());
+}
+
+- (void)testVisitorPerformance {
+  tree::ParseTreeTracker tracker;
+  size_t rules;
+  ParserRuleContext *root = buildTree(tracker, 200000, rules);
+  TerminalCounter counter;
+
+  // Scalar results live inline in antlrcpp::Any, so visiting doesn't allocate.
+  size_t allocations = allocationCount;
+  size_t terminals = counter.visit(root).as<size_t>();
+  XCTAssertEqual(allocationCount, allocations);
+  XCTAssertEqual(terminals, 200000 - rules);
+
+  [self measureBlock:^{
+    XCTAssertEqual(counter.visit(root).as<size_t>(), terminals);
+  }];
+}
+
 - (void)testCPPUtils {
 
   class A { public: virtual ~A() {}; };
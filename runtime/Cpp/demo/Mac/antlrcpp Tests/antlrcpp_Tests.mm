@@ -30,14 +30,79 @@
 #import <Cocoa/Cocoa.h>
 #import <XCTest/XCTest.h>
 
-#include "ParserATNSimulator.h"
-#include "DFA.h"
-#include "ATN.h"
+#include "antlr4-runtime.h"
+
+#include "TLexer.h"
+#include "TParser.h"
 
 #include <vector>
 
 using namespace antlr4;
 
+// Statements with several syntax errors each, which the parser must recover from.
+static std::string errorText(size_t count) {
+  static const char *statements[] = {
+    "a = = 1 + ;\n",
+    "b * * (c + 2;\n",
+    "value = (1 + 2));\n",
+    "x y z = 3;\n",
+    "d = 4 + (e * ;\n",
+  };
+
+  std::string text;
+  for (size_t i = 0; i < count; ++i) {
+    text += statements[i % 5];
+  }
+  return text;
+}
+
+// Compares the expected tokens and the error recovery set at every syntax error with the sets computed while the
+// follow set cache is disabled.
+class CheckingErrorStrategy : public DefaultErrorStrategy {
+public:
+  size_t checks = 0;
+  size_t mismatches = 0;
+
+  virtual void reportError(Parser *recognizer, const RecognitionException &e) override {
+    check(recognizer);
+    DefaultErrorStrategy::reportError(recognizer, e);
+  }
+
+protected:
+  virtual void reportUnwantedToken(Parser *recognizer) override {
+    check(recognizer);
+    DefaultErrorStrategy::reportUnwantedToken(recognizer);
+  }
+
+  virtual void reportMissingToken(Parser *recognizer) override {
+    check(recognizer);
+    DefaultErrorStrategy::reportMissingToken(recognizer);
+  }
+
+private:
+  void check(Parser *recognizer) {
+    atn::FollowSetCache &cache = recognizer->getATN().getFollowSetCache();
+
+    // The first call might add the sets to the cache, the second one returns the cached sets.
+    misc::IntervalSet expected = recognizer->getExpectedTokens();
+    misc::IntervalSet recoverySet = getErrorRecoverySet(recognizer);
+    misc::IntervalSet cachedExpected = recognizer->getExpectedTokens();
+    misc::IntervalSet cachedRecoverySet = getErrorRecoverySet(recognizer);
+
+    size_t maxSize = cache.getMaxSize();
+    cache.setMaxSize(0);
+    misc::IntervalSet uncachedExpected = recognizer->getExpectedTokens();
+    misc::IntervalSet uncachedRecoverySet = getErrorRecoverySet(recognizer);
+    cache.setMaxSize(maxSize);
+
+    ++checks;
+    if (!(expected == uncachedExpected) || !(cachedExpected == uncachedExpected) ||
+        !(recoverySet == uncachedRecoverySet) || !(cachedRecoverySet == uncachedRecoverySet)) {
+      ++mismatches;
+    }
+  }
+};
+
 @interface antlrcpp_Tests : XCTestCase
 
 @end
@@ -54,4 +119,37 @@ using namespace antlr4;
     [super tearDown];
 }
 
+- (void)testFollowSetCache {
+  ANTLRInputStream input(errorText(500));
+  antlrcpptest::TLexer lexer(&input);
+  CommonTokenStream tokens(&lexer);
+  antlrcpptest::TParser parser(&tokens);
+  parser.removeErrorListeners();
+  auto strategy = std::make_shared<CheckingErrorStrategy>();
+  parser.setErrorHandler(strategy);
+
+  parser.getATN().getFollowSetCache().clear();
+  parser.main();
+
+  XCTAssertGreaterThanOrEqual(parser.getNumberOfSyntaxErrors(), 500U);
+  XCTAssertGreaterThan(strategy->checks, 500U);
+  XCTAssertEqual(strategy->mismatches, 0U);
+  XCTAssertGreaterThan(parser.getATN().getFollowSetCache().size(), 0U);
+}
+
+- (void)testSyntaxErrorPerformance {
+  std::string text = errorText(1000);
+
+  [self measureBlock:^{
+    ANTLRInputStream input(text);
+    antlrcpptest::TLexer lexer(&input);
+    CommonTokenStream tokens(&lexer);
+    antlrcpptest::TParser parser(&tokens);
+    parser.removeErrorListeners();
+    parser.main();
+
+    XCTAssertGreaterThanOrEqual(parser.getNumberOfSyntaxErrors(), 1000U);
+  }];
+}
+
 @end
@@ -52,7 +52,9 @@ namespace antlr4 {
      *
      * @param recognizer the parser instance
      * @throws RecognitionException if the error strategy was not able to
-     * recover from the unexpected input symbol
+     * recover from the unexpected input symbol. With exception free recovery
+     * (see Parser::setExceptionFreeRecovery) the strategy may instead call
+     * Parser::recoverFromError and return null.
      */
     virtual Token* recoverInline(Parser *recognizer) = 0;
 
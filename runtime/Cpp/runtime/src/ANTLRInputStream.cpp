@@ -34,19 +34,56 @@ ANTLRInputStream::ANTLRInputStream(std::istream &stream) {
 void ANTLRInputStream::load(const std::string &input) {
   // Remove the UTF-8 BOM if present.
   const char bom[4] = "\xef\xbb\xbf";
+  const char *first = input.data();
+  const char *last = input.data() + input.size();
   if (input.compare(0, 3, bom, 3) == 0)
-    _data = antlrcpp::utf8_to_utf32(input.data() + 3, input.data() + input.size());
-  else
-    _data = antlrcpp::utf8_to_utf32(input.data(), input.data() + input.size());
+    first += 3;
+
+  _data8.clear();
+  _data16.clear();
+  _data32.clear();
   p = 0;
+
+  // The largest byte tells us the largest possible code point: lead bytes up to 0xC3 encode Latin-1,
+  // lead bytes below 0xF0 the BMP.
+  unsigned char maxByte = 0;
+  for (const char *c = first; c != last; ++c) {
+    maxByte = std::max(maxByte, static_cast<unsigned char>(*c));
+  }
+
+  bool valid;
+  size_t errorOffset = 0;
+  if (maxByte < 0x80) {
+    _width = 1;
+    _isAscii = true;
+    _codePointReader = &ANTLRInputStream::latin1CodePointAt;
+    _data8.assign(first, last);
+    valid = true;
+  } else if (maxByte < 0xC4) {
+    _width = 1;
+    _isAscii = false;
+    _codePointReader = &ANTLRInputStream::latin1CodePointAt;
+    valid = antlrcpp::utf8_to_latin1(first, last, _data8, errorOffset);
+  } else if (maxByte < 0xF0) {
+    _width = 2;
+    _codePointReader = &ANTLRInputStream::ucs2CodePointAt;
+    valid = antlrcpp::utf8_to_ucs2(first, last, _data16, errorOffset);
+  } else {
+    _width = 4;
+    _codePointReader = &ANTLRInputStream::utf32CodePointAt;
+    valid = antlrcpp::utf8_to_utf32(first, last, _data32, errorOffset);
+  }
+  _length = _data8.size() + _data16.size() + _data32.size(); // Only one of them holds data.
+
+  if (!valid) {
+    throw std::range_error("invalid UTF-8 sequence at byte offset " + std::to_string(errorOffset));
+  }
 }
 
 void ANTLRInputStream::load(std::istream &stream) {
   if (!stream.good() || stream.eof()) // No fail, bad or EOF.
     return;
 
-  _data.clear();
-
   std::string s((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
   load(s);
 }
@@ -56,14 +93,12 @@ void ANTLRInputStream::reset() {
 }
 
 void ANTLRInputStream::consume() {
-  if (p >= _data.size()) {
+  if (p >= length()) {
     assert(LA(1) == IntStream::EOF);
     throw IllegalStateException("cannot consume EOF");
   }
 
-  if (p < _data.size()) {
-    p++;
-  }
+  p++;
 }
 
 size_t ANTLRInputStream::LA(ssize_t i) {
@@ -79,11 +114,7 @@ size_t ANTLRInputStream::LA(ssize_t i) {
     }
   }
 
-  if ((position + i - 1) >= static_cast<ssize_t>(_data.size())) {
-    return IntStream::EOF;
-  }
-
-  return _data[static_cast<size_t>((position + i - 1))];
+  return codePointAt(static_cast<size_t>(position + i - 1));
 }
 
 size_t ANTLRInputStream::LT(ssize_t i) {
@@ -95,7 +126,7 @@ size_t ANTLRInputStream::index() {
 }
 
 size_t ANTLRInputStream::size() {
-  return _data.size();
+  return length();
 }
 
 // Mark/release do nothing. We have entire buffer.
@@ -112,7 +143,7 @@ void ANTLRInputStream::seek(size_t index) {
     return;
   }
   // seek forward, consume until p hits index or n (whichever comes first)
-  index = std::min(index, _data.size());
+  index = std::min(index, length());
   while (p < index) {
     consume();
   }
@@ -125,18 +156,18 @@ std::string ANTLRInputStream::getText(const Interval &interval) {
 
   size_t start = static_cast<size_t>(interval.a);
   size_t stop = static_cast<size_t>(interval.b);
+  size_t size = length();
 
-
-  if (stop >= _data.size()) {
-    stop = _data.size() - 1;
+  if (stop >= size) {
+    stop = size - 1;
   }
 
   size_t count = stop - start + 1;
-  if (start >= _data.size()) {
+  if (start >= size) {
     return "";
   }
 
-  return antlrcpp::utf32_to_utf8(_data.substr(start, count));
+  return getText(start, count);
 }
 
 std::string ANTLRInputStream::getSourceName() const {
@@ -147,9 +178,60 @@ std::string ANTLRInputStream::getSourceName() const {
 }
 
 std::string ANTLRInputStream::toString() const {
-  return antlrcpp::utf32_to_utf8(_data);
+  return getText(0, std::string::npos);
+}
+
+size_t ANTLRInputStream::codePointAt(size_t index) const {
+  if (index >= _length) {
+    return IntStream::EOF;
+  }
+  return _codePointReader(*this, index);
+}
+
+size_t ANTLRInputStream::latin1CodePointAt(const ANTLRInputStream &stream, size_t index) {
+  return static_cast<unsigned char>(stream._data8[index]);
+}
+
+size_t ANTLRInputStream::ucs2CodePointAt(const ANTLRInputStream &stream, size_t index) {
+  return stream._data16[index];
+}
+
+size_t ANTLRInputStream::utf32CodePointAt(const ANTLRInputStream &stream, size_t index) {
+  return stream._data32[index];
+}
+
+std::string ANTLRInputStream::getText(size_t start, size_t count) const {
+  switch (_width) {
+    case 1: {
+      count = std::min(count, _data8.size() - start);
+      if (_isAscii) {
+        return _data8.substr(start, count);
+      }
+      return antlrcpp::latin1_to_utf8(_data8.data() + start, _data8.data() + start + count);
+    }
+
+    case 2: {
+      count = std::min(count, _data16.size() - start);
+      return antlrcpp::ucs2_to_utf8(_data16.data() + start, _data16.data() + start + count);
+    }
+
+    default: {
+      // Convert in place, without an intermediate substring.
+      count = std::min(count, _data32.size() - start);
+      auto data = reinterpret_cast<const char32_t *>(_data32.data()) + start;
+      return antlrcpp::utf32_to_utf8(data, data + count);
+    }
+  }
+}
+
+size_t ANTLRInputStream::length() const {
+  return _length;
 }
 
 void ANTLRInputStream::InitializeInstanceFields() {
   p = 0;
+  _width = 1;
+  _isAscii = true;
+  _length = 0;
+  _codePointReader = &ANTLRInputStream::latin1CodePointAt;
 }
@@ -11,13 +11,9 @@ namespace antlr4 {
 
   // Vacuum all input from a stream and then treat it
   // like a string. Can also pass in a string or char[] to use.
-  // Input is expected to be encoded in UTF-8 and converted to UTF-32 internally.
+  // Input is expected to be encoded in UTF-8 and converted to fixed width code points internally.
   class ANTLR4CPP_PUBLIC ANTLRInputStream : public CharStream {
   protected:
-    /// The data being scanned.
-    // UTF-32
-    UTF32String _data;
-
     /// 0..n-1 index into string of next char </summary>
     size_t p;
 
@@ -62,7 +58,42 @@ namespace antlr4 {
     virtual std::string getSourceName() const override;
     virtual std::string toString() const override;
 
+  protected:
+    /// The code point at the given index, or EOF for an index past the end. Subclasses use this (together with
+    /// length() and getText(start, count)) to read the input, which is not stored in a single string anymore.
+    size_t codePointAt(size_t index) const;
+
+    /// Converts count code points (clamped to the stream size) starting at start to UTF-8.
+    std::string getText(size_t start, size_t count) const;
+
+    /// Non-virtual version of size().
+    size_t length() const;
+
   private:
+    /// The data being scanned. The input is stored with the smallest element width which can hold all
+    /// of its code points: 1 byte for Latin-1 (which includes ASCII), 2 bytes for the BMP and 4 bytes
+    /// otherwise. Only the member which matches _width holds data.
+    std::string _data8;     // Latin-1
+    std::u16string _data16; // UCS-2
+    UTF32String _data32;    // UTF-32
+
+    /// The size of a code point in bytes (1, 2 or 4).
+    size_t _width;
+
+    /// True if _data8 only contains ASCII, which allows to return text without conversion.
+    bool _isAscii;
+
+    /// The number of code points in the member which holds data.
+    size_t _length;
+
+    /// Reads a code point (index < _length) from the member which holds data. It is selected when input is loaded,
+    /// so that LA() doesn't need to check _width.
+    size_t (*_codePointReader)(const ANTLRInputStream &stream, size_t index);
+
+    static size_t latin1CodePointAt(const ANTLRInputStream &stream, size_t index);
+    static size_t ucs2CodePointAt(const ANTLRInputStream &stream, size_t index);
+    static size_t utf32CodePointAt(const ANTLRInputStream &stream, size_t index);
+
     void InitializeInstanceFields();
   };
 
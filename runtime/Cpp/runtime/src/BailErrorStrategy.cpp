@@ -21,6 +21,11 @@ void BailErrorStrategy::recover(Parser *recognizer, std::exception_ptr e) {
     context = static_cast<ParserRuleContext *>(context->parent);
   } while (true);
 
+  if (e == nullptr) {
+    // A recovered error without a stored exception, see Parser::setStoreRecoveredExceptions().
+    throw ParseCancellationException();
+  }
+
   try {
     std::rethrow_exception(e); // Throw the exception to be able to catch and rethrow nested.
 #if defined(_MSC_FULL_VER) && _MSC_FULL_VER < 190023026
@@ -99,10 +99,14 @@ size_t BufferedTokenStream::fetch(size_t n) {
       (static_cast<WritableToken *>(t.get()))->setTokenIndex(_tokens.size());
     }
 
+    bool isEOF = t->getType() == Token::EOF;
+    if (isEOF || t->getChannel() == _indexedChannel) {
+      _onChannelTokens.push_back(_tokens.size());
+    }
     _tokens.push_back(std::move(t));
     ++i;
 
-    if (_tokens.back()->getType() == Token::EOF) {
+    if (isEOF) {
       _fetchedEOF = true;
       break;
     }
@@ -192,6 +196,8 @@ void BufferedTokenStream::setup() {
 void BufferedTokenStream::setTokenSource(TokenSource *tokenSource) {
   _tokenSource = tokenSource;
   _tokens.clear();
+  _onChannelTokens.clear();
+  _onChannelHint = 0;
   _fetchedEOF = false;
   _needSetup = true;
 }
@@ -246,6 +252,17 @@ ssize_t BufferedTokenStream::nextTokenOnChannel(size_t i, size_t channel) {
     return size() - 1;
   }
 
+  if (channel == _indexedChannel) {
+    size_t position = onChannelPosition(i);
+    while (position == _onChannelTokens.size()) {
+      if (fetch(1) == 0) {
+        return size() - 1;
+      }
+      position = onChannelPosition(i);
+    }
+    return _onChannelTokens[position];
+  }
+
   Token *token = _tokens[i].get();
   while (token->getChannel() != channel) {
     if (token->getType() == Token::EOF) {
@@ -265,6 +282,15 @@ ssize_t BufferedTokenStream::previousTokenOnChannel(size_t i, size_t channel) {
     return size() - 1;
   }
 
+  if (channel == _indexedChannel) {
+    // All tokens up to i are fetched, so the index is complete for this range.
+    size_t position = onChannelPosition(i);
+    if (position < _onChannelTokens.size() && _onChannelTokens[position] == i) {
+      return i;
+    }
+    return position == 0 ? -1 : static_cast<ssize_t>(_onChannelTokens[position - 1]);
+  }
+
   while (true) {
     Token *token = _tokens[i].get();
     if (token->getType() == Token::EOF || token->getChannel() == channel) {
@@ -345,6 +371,24 @@ std::vector<Token *> BufferedTokenStream::filterForChannel(size_t from, size_t t
   return hidden;
 }
 
+size_t BufferedTokenStream::onChannelPosition(size_t i) {
+  // Most lookups are for the current token or the one following it.
+  size_t hint = _onChannelHint;
+  for (size_t position = hint; position < _onChannelTokens.size() && position <= hint + 1; ++position) {
+    if (_onChannelTokens[position] >= i) {
+      if (position == 0 || _onChannelTokens[position - 1] < i) {
+        _onChannelHint = position;
+        return position;
+      }
+      break;
+    }
+  }
+
+  auto iterator = std::lower_bound(_onChannelTokens.begin(), _onChannelTokens.end(), i);
+  _onChannelHint = static_cast<size_t>(iterator - _onChannelTokens.begin());
+  return _onChannelHint;
+}
+
 bool BufferedTokenStream::isInitialized() const {
   return !_needSetup;
 }
@@ -410,4 +454,6 @@ void BufferedTokenStream::fill() {
 void BufferedTokenStream::InitializeInstanceFields() {
   _needSetup = true;
   _fetchedEOF = false;
+  _indexedChannel = Lexer::DEFAULT_TOKEN_CHANNEL;
+  _onChannelHint = 0;
 }
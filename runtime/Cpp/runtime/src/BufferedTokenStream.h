@@ -137,6 +137,16 @@ namespace antlr4 {
      */
     bool _fetchedEOF;
 
+    /// The channel for which {@link #_onChannelTokens} is maintained. Defaults to
+    /// {@link Lexer#DEFAULT_TOKEN_CHANNEL}, which is what the hidden token lookups need.
+    size_t _indexedChannel;
+
+    /// The indices of all fetched tokens on {@link #_indexedChannel} in ascending order, including the
+    /// EOF token (which is on every channel). This list is extended in {@link #fetch}, so that looking
+    /// for the next or previous on-channel token is a lookup instead of a scan over all hidden tokens.
+    /// Note: changing the channel of a token after it was fetched is not reflected here.
+    std::vector<size_t> _onChannelTokens;
+
     /// <summary>
     /// Make sure index {@code i} in tokens has a token.
     /// </summary>
@@ -190,10 +200,15 @@ namespace antlr4 {
 
     virtual std::vector<Token *> filterForChannel(size_t from, size_t to, ssize_t channel);
 
+    /// Returns the position in {@link #_onChannelTokens} of the first on-channel token with an index
+    /// >= {@code i}, or _onChannelTokens.size() if there is none (yet). Sequential calls are O(1).
+    size_t onChannelPosition(size_t i);
+
     bool isInitialized() const;
 
   private:
     bool _needSetup;
+    size_t _onChannelHint; // Result of the last onChannelPosition() call.
     void InitializeInstanceFields();
   };
 
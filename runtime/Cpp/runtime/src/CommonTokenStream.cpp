@@ -14,6 +14,7 @@ CommonTokenStream::CommonTokenStream(TokenSource *tokenSource) : CommonTokenStre
 
 CommonTokenStream::CommonTokenStream(TokenSource *tokenSource, size_t channel_)
 : BufferedTokenStream(tokenSource), channel(channel_) {
+  _indexedChannel = channel;
 }
 
 ssize_t CommonTokenStream::adjustSeekIndex(size_t i) {
@@ -25,6 +26,15 @@ Token* CommonTokenStream::LB(size_t k) {
     return nullptr;
   }
 
+  if (channel == _indexedChannel) {
+    // The k-th on-channel token before _p.
+    size_t position = onChannelPosition(_p);
+    if (position < k) {
+      return nullptr;
+    }
+    return _tokens[_onChannelTokens[position - k]].get();
+  }
+
   ssize_t i = static_cast<ssize_t>(_p);
   size_t n = 1;
   // find k good tokens looking backwards
@@ -48,6 +58,21 @@ Token* CommonTokenStream::LT(ssize_t k) {
   if (k < 0) {
     return LB(static_cast<size_t>(-k));
   }
+
+  // _p is always on channel (see adjustSeekIndex), so LT(k) is k - 1 entries further in the index.
+  if (channel == _indexedChannel) {
+    size_t position = onChannelPosition(_p);
+    if (position < _onChannelTokens.size() && _onChannelTokens[position] == _p) {
+      size_t target = position + static_cast<size_t>(k) - 1;
+      while (target >= _onChannelTokens.size()) {
+        if (fetch(1) == 0) {
+          return _tokens.back().get(); // EOF, which is always the last indexed token.
+        }
+      }
+      return _tokens[_onChannelTokens[target]].get();
+    }
+  }
+
   size_t i = _p;
   ssize_t n = 1; // we know tokens[p] is a good one
                  // find k good tokens
@@ -65,6 +90,14 @@ Token* CommonTokenStream::LT(ssize_t k) {
 int CommonTokenStream::getNumberOfOnChannelTokens() {
   int n = 0;
   fill();
+  if (channel == _indexedChannel) {
+    n = static_cast<int>(_onChannelTokens.size());
+    if (!_tokens.empty() && _tokens.back()->getType() == Token::EOF && _tokens.back()->getChannel() != channel) {
+      n--;
+    }
+    return n;
+  }
+
   for (size_t i = 0; i < _tokens.size(); i++) {
     Token *t = _tokens[i].get();
     if (t->getChannel() == channel) {
@@ -24,6 +24,19 @@ using namespace antlr4::atn;
 
 using namespace antlrcpp;
 
+namespace {
+
+  // See Parser::setStoreRecoveredExceptions().
+  template<typename T>
+  std::exception_ptr makeExceptionPointer(Parser *recognizer, const T &e) {
+    if (recognizer->isExceptionFreeRecovery() && !recognizer->getStoreRecoveredExceptions()) {
+      return nullptr;
+    }
+    return std::make_exception_ptr(e);
+  }
+
+}
+
 DefaultErrorStrategy::DefaultErrorStrategy() {
   InitializeInstanceFields();
 }
@@ -115,6 +128,10 @@ void DefaultErrorStrategy::sync(Parser *recognizer) {
         return;
       }
 
+      if (recognizer->isExceptionFreeRecovery()) {
+        recognizer->recoverFromError(InputMismatchException(recognizer));
+        return;
+      }
       throw InputMismatchException(recognizer);
 
     case atn::ATNState::PLUS_LOOP_BACK:
@@ -145,19 +162,19 @@ void DefaultErrorStrategy::reportNoViableAlternative(Parser *recognizer, const N
     input = "<unknown input>";
   }
   std::string msg = "no viable alternative at input " + escapeWSAndQuote(input);
-  recognizer->notifyErrorListeners(e.getOffendingToken(), msg, std::make_exception_ptr(e));
+  recognizer->notifyErrorListeners(e.getOffendingToken(), msg, makeExceptionPointer(recognizer, e));
 }
 
 void DefaultErrorStrategy::reportInputMismatch(Parser *recognizer, const InputMismatchException &e) {
   std::string msg = "mismatched input " + getTokenErrorDisplay(e.getOffendingToken()) +
   " expecting " + e.getExpectedTokens().toString(recognizer->getVocabulary());
-  recognizer->notifyErrorListeners(e.getOffendingToken(), msg, std::make_exception_ptr(e));
+  recognizer->notifyErrorListeners(e.getOffendingToken(), msg, makeExceptionPointer(recognizer, e));
 }
 
 void DefaultErrorStrategy::reportFailedPredicate(Parser *recognizer, const FailedPredicateException &e) {
   const std::string& ruleName = recognizer->getRuleNames()[recognizer->getContext()->getRuleIndex()];
   std::string msg = "rule " + ruleName + " " + e.what();
-  recognizer->notifyErrorListeners(e.getOffendingToken(), msg, std::make_exception_ptr(e));
+  recognizer->notifyErrorListeners(e.getOffendingToken(), msg, makeExceptionPointer(recognizer, e));
 }
 
 void DefaultErrorStrategy::reportUnwantedToken(Parser *recognizer) {
@@ -205,7 +222,11 @@ Token* DefaultErrorStrategy::recoverInline(Parser *recognizer) {
     return getMissingSymbol(recognizer);
   }
 
-  // Even that didn't work; must throw the exception.
+  // Even that didn't work; must throw the exception (or recover without one, which leaves no token).
+  if (recognizer->isExceptionFreeRecovery()) {
+    recognizer->recoverFromError(InputMismatchException(recognizer));
+    return nullptr;
+  }
   throw InputMismatchException(recognizer);
 }
 
@@ -301,22 +322,26 @@ std::string DefaultErrorStrategy::escapeWSAndQuote(const std::string &s) const {
 
 misc::IntervalSet DefaultErrorStrategy::getErrorRecoverySet(Parser *recognizer) {
   const atn::ATN &atn = recognizer->getInterpreter<atn::ATNSimulator>()->atn;
-  RuleContext *ctx = recognizer->getContext();
-  misc::IntervalSet recoverSet;
-  while (ctx->invokingState != ATNState::INVALID_STATE_NUMBER) {
-    // compute what follows who invoked us
-    atn::ATNState *invokingState = atn.states[ctx->invokingState];
-    atn::RuleTransition *rt = dynamic_cast<atn::RuleTransition*>(invokingState->transitions[0]);
-    misc::IntervalSet follow = atn.nextTokens(rt->followState);
-    recoverSet.addAll(follow);
-
-    if (ctx->parent == nullptr)
-      break;
-    ctx = static_cast<RuleContext *>(ctx->parent);
-  }
-  recoverSet.remove(Token::EPSILON);
 
-  return recoverSet;
+  // The set only depends on the invocation stack, so it is cached under the invalid state number.
+  return atn.getFollowSetCache().get(ATNState::INVALID_STATE_NUMBER, recognizer->getContext(), [&]() {
+    RuleContext *ctx = recognizer->getContext();
+    misc::IntervalSet recoverSet;
+    while (ctx->invokingState != ATNState::INVALID_STATE_NUMBER) {
+      // compute what follows who invoked us
+      atn::ATNState *invokingState = atn.states[ctx->invokingState];
+      atn::RuleTransition *rt = static_cast<atn::RuleTransition*>(invokingState->transitions[0]);
+      const misc::IntervalSet &follow = atn.nextTokens(rt->followState);
+      recoverSet.addAll(follow);
+
+      if (ctx->parent == nullptr)
+        break;
+      ctx = static_cast<RuleContext *>(ctx->parent);
+    }
+    recoverSet.remove(Token::EPSILON);
+
+    return recoverSet;
+  });
 }
 
 void DefaultErrorStrategy::consumeUntil(Parser *recognizer, const misc::IntervalSet &set) {
@@ -0,0 +1,172 @@
+﻿/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "atn/LexerATNSimulator.h"
+#include "Exceptions.h"
+#include "CommonToken.h"
+#include "Lexer.h"
+
+#include "IncrementalLexer.h"
+
+using namespace antlr4;
+
+IncrementalLexer::IncrementalLexer(Lexer *lexer) : _lexer(lexer) {
+}
+
+IncrementalLexer::~IncrementalLexer() {
+}
+
+void IncrementalLexer::lexAll() {
+  _tokens.clear();
+  _states.clear();
+  _lexer->reset();
+
+  size_t lookahead = 0;
+  while (true) {
+    LexerState state;
+    std::unique_ptr<Token> token = nextToken(state, lookahead);
+    lookahead = state.maxLookaheadIndex;
+
+    bool done = token->getType() == Token::EOF;
+    _tokens.push_back(std::move(token));
+    _states.push_back(std::move(state));
+    if (done) {
+      break;
+    }
+  }
+}
+
+IncrementalLexer::TokenChange IncrementalLexer::relex(size_t offset, size_t removedLength, size_t insertedLength) {
+  if (_tokens.empty()) {
+    lexAll();
+    return { 0, 0, _tokens.size() };
+  }
+
+  // The lookahead values are monotonic, so this finds the first token whose match depended on
+  // the edited text. There is always one, because the EOF token looked at the end of the input.
+  auto iterator = std::lower_bound(_states.begin(), _states.end(), offset, [](const LexerState &state, size_t value) {
+    return state.maxLookaheadIndex < value;
+  });
+  size_t start = std::min(static_cast<size_t>(iterator - _states.begin()), _states.size() - 1);
+
+  restoreState(_states[start]);
+  atn::LexerATNSimulator *simulator = _lexer->getInterpreter<atn::LexerATNSimulator>();
+  size_t lookahead = (start > 0) ? _states[start - 1].maxLookaheadIndex : 0;
+
+  std::vector<std::unique_ptr<Token>> newTokens;
+  std::vector<LexerState> newStates;
+  size_t candidate = start; // The next old token which could be in sync with the new input.
+  size_t stop = _tokens.size();
+  while (true) {
+    // Old and new tokens can only align again behind the edited text. From there on the lexer
+    // produces the same tokens if it starts at the same place in the same state.
+    size_t position = _lexer->_input->index();
+    if (position >= offset + insertedLength) {
+      size_t oldPosition = position - insertedLength + removedLength;
+      while (candidate < _states.size() && _states[candidate].startIndex < oldPosition) {
+        ++candidate;
+      }
+
+      if (candidate < _states.size()) {
+        const LexerState &state = _states[candidate];
+        if (state.startIndex == oldPosition && state.mode == _lexer->mode && state.modeStack == _lexer->modeStack &&
+            state.charPositionInLine == simulator->getCharPositionInLine()) {
+          stop = candidate;
+          break;
+        }
+      }
+    }
+
+    LexerState state;
+    std::unique_ptr<Token> token = nextToken(state, lookahead);
+    lookahead = state.maxLookaheadIndex;
+
+    bool done = token->getType() == Token::EOF;
+    newTokens.push_back(std::move(token));
+    newStates.push_back(std::move(state));
+    if (done) {
+      break;
+    }
+  }
+
+  // Shift all reused tokens to their new position. Unsigned wrap-around gives the right results here.
+  if (stop < _tokens.size()) {
+    size_t oldLine = _states[stop].line;
+    size_t newLine = simulator->getLine();
+    for (size_t i = stop; i < _tokens.size(); ++i) {
+      CommonToken *token = dynamic_cast<CommonToken *>(_tokens[i].get());
+      if (token == nullptr) {
+        throw IllegalStateException("incremental relexing requires CommonToken instances");
+      }
+
+      token->setStartIndex(token->getStartIndex() + insertedLength - removedLength);
+      token->setStopIndex(token->getStopIndex() + insertedLength - removedLength);
+      token->setLine(token->getLine() + newLine - oldLine);
+
+      LexerState &state = _states[i];
+      state.startIndex += insertedLength - removedLength;
+      state.line += newLine - oldLine;
+      state.maxLookaheadIndex = std::max(lookahead, state.maxLookaheadIndex + insertedLength - removedLength);
+      lookahead = state.maxLookaheadIndex;
+    }
+  }
+
+  _tokens.erase(_tokens.begin() + static_cast<ssize_t>(start), _tokens.begin() + static_cast<ssize_t>(stop));
+  _tokens.insert(_tokens.begin() + static_cast<ssize_t>(start), std::make_move_iterator(newTokens.begin()),
+    std::make_move_iterator(newTokens.end()));
+  _states.erase(_states.begin() + static_cast<ssize_t>(start), _states.begin() + static_cast<ssize_t>(stop));
+  _states.insert(_states.begin() + static_cast<ssize_t>(start), std::make_move_iterator(newStates.begin()),
+    std::make_move_iterator(newStates.end()));
+
+  return { start, stop - start, newTokens.size() };
+}
+
+IncrementalLexer::TokenChange IncrementalLexer::relex(size_t offset, size_t removedLength, const std::string &insertedText) {
+  size_t insertedLength = 0;
+  for (char c : insertedText) {
+    if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) { // Count all but continuation bytes.
+      ++insertedLength;
+    }
+  }
+  return relex(offset, removedLength, insertedLength);
+}
+
+const std::vector<std::unique_ptr<Token>>& IncrementalLexer::getTokens() const {
+  return _tokens;
+}
+
+std::vector<std::unique_ptr<Token>> IncrementalLexer::releaseTokens() {
+  _states.clear();
+  return std::move(_tokens);
+}
+
+Lexer* IncrementalLexer::getLexer() const {
+  return _lexer;
+}
+
+std::unique_ptr<Token> IncrementalLexer::nextToken(LexerState &state, size_t previousLookahead) {
+  atn::LexerATNSimulator *simulator = _lexer->getInterpreter<atn::LexerATNSimulator>();
+  state.startIndex = _lexer->_input->index();
+  state.line = simulator->getLine();
+  state.charPositionInLine = simulator->getCharPositionInLine();
+  state.mode = _lexer->mode;
+  state.modeStack = _lexer->modeStack;
+
+  simulator->setMaxLookaheadIndex(previousLookahead);
+  std::unique_ptr<Token> token = _lexer->nextToken();
+  state.maxLookaheadIndex = std::max(simulator->getMaxLookaheadIndex(), _lexer->_input->index());
+
+  return token;
+}
+
+void IncrementalLexer::restoreState(const LexerState &state) {
+  _lexer->_input->seek(state.startIndex);
+  _lexer->setLine(state.line);
+  _lexer->setCharPositionInLine(state.charPositionInLine);
+  _lexer->mode = state.mode;
+  _lexer->modeStack = state.modeStack;
+  _lexer->hitEOF = false;
+  _lexer->token.reset();
+}
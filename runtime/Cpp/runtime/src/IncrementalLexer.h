@@ -0,0 +1,79 @@
+﻿/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "Token.h"
+
+namespace antlr4 {
+
+  /// Drives a lexer over its input and keeps the resulting token list, together with the lexer state
+  /// at the start of each token. After the text of the input stream has been changed the list can be
+  /// updated by relexing only the region around the edit: lexing restarts at the last token which
+  /// did not look at the edited text (with mode and mode stack restored) and stops as soon as the new
+  /// tokens line up with the old ones again. All tokens after that point are reused and shifted.
+  ///
+  /// The lexer must keep using the same CharStream instance (e.g. an ANTLRInputStream which is
+  /// reloaded with the new text), as reused tokens still refer to it.
+  /// Lexer actions which look at input beyond the matched text are not tracked.
+  class ANTLR4CPP_PUBLIC IncrementalLexer {
+  public:
+    /// Describes which part of the token list changed in a call to relex().
+    struct ANTLR4CPP_PUBLIC TokenChange {
+      /// Index of the first token which was replaced.
+      size_t start;
+
+      /// The number of tokens removed from the old list, starting at {@code start}.
+      size_t removed;
+
+      /// The number of newly lexed tokens, starting at {@code start}.
+      size_t inserted;
+    };
+
+    IncrementalLexer(Lexer *lexer);
+    virtual ~IncrementalLexer();
+
+    /// Resets the lexer and tokenizes its entire input. The EOF token is part of the result.
+    virtual void lexAll();
+
+    /// Updates the token list after an edit of the input. The input stream of the lexer must already
+    /// contain the edited text. All values are given in code points (the index unit of CharStream).
+    virtual TokenChange relex(size_t offset, size_t removedLength, size_t insertedLength);
+
+    /// Convenience overload, which computes the inserted length from the UTF-8 encoded text.
+    virtual TokenChange relex(size_t offset, size_t removedLength, const std::string &insertedText);
+
+    virtual const std::vector<std::unique_ptr<Token>>& getTokens() const;
+
+    /// Transfers ownership of all tokens to the caller. The token list is empty afterwards.
+    virtual std::vector<std::unique_ptr<Token>> releaseTokens();
+
+    virtual Lexer* getLexer() const;
+
+  protected:
+    /// The lexer state at the point where nextToken() was called for a token.
+    struct LexerState {
+      size_t startIndex; // May be before the token's start index, if input was skipped.
+      size_t line;
+      size_t charPositionInLine;
+      size_t mode;
+      std::vector<size_t> modeStack;
+
+      /// The highest input index examined while lexing this or any earlier token.
+      size_t maxLookaheadIndex;
+    };
+
+    Lexer *_lexer;
+    std::vector<std::unique_ptr<Token>> _tokens;
+    std::vector<LexerState> _states; // One per token in _tokens.
+
+    /// Fetches the next token from the lexer and records the state it started in.
+    virtual std::unique_ptr<Token> nextToken(LexerState &state, size_t previousLookahead);
+
+    /// Puts the lexer back into the given state, so that lexing continues from there.
+    virtual void restoreState(const LexerState &state);
+  };
+
+} // namespace antlr4
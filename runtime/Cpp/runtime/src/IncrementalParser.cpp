@@ -0,0 +1,272 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "ANTLRErrorStrategy.h"
+#include "IncrementalTokenStream.h"
+#include "Token.h"
+#include "tree/TerminalNode.h"
+
+#include "IncrementalParser.h"
+
+using namespace antlr4;
+using namespace antlr4::tree;
+
+namespace {
+
+  size_t startIndex(ParseTree *node) {
+    Token *token;
+    if (node->getTreeType() == ParseTreeType::RULE) {
+      token = static_cast<ParserRuleContext *>(node)->start;
+    } else {
+      token = static_cast<TerminalNode *>(node)->getSymbol();
+    }
+    return token == nullptr ? INVALID_INDEX : token->getTokenIndex();
+  }
+
+  /// The child which contains the token with the given index, if any.
+  ParseTree* childAt(ParserRuleContext *ctx, size_t index) {
+    // Children are ordered by position, so this is the last child which starts at or before the token.
+    auto &children = ctx->children;
+    auto child = std::upper_bound(children.begin(), children.end(), index, [](size_t i, ParseTree *node) {
+      return i < startIndex(node);
+    });
+    if (child == children.begin()) {
+      return nullptr;
+    }
+    return *(child - 1);
+  }
+
+}
+
+IncrementalParser::IncrementalParser(TokenStream *input)
+  : Parser(input), _oldTree(nullptr), _change({ 0, 0, 0 }), _preparingReparse(false), _reusedContexts(0),
+    _checkedInput(nullptr), _incrementalInput(nullptr) {
+}
+
+IncrementalParser::~IncrementalParser() {
+}
+
+void IncrementalParser::setReparseInput(TokenStream *newInput, ParserRuleContext *oldTree,
+                                        const IncrementalLexer::TokenChange &change) {
+  // The old tree must survive the reset in setTokenStream().
+  _previousTrees.adopt(_tracker);
+  _preparingReparse = true;
+  setTokenStream(newInput);
+  _preparingReparse = false;
+
+  _oldTree = oldTree;
+  _change = change;
+  _reusedContexts = 0;
+}
+
+size_t IncrementalParser::getReusedContextCount() const {
+  return _reusedContexts;
+}
+
+void IncrementalParser::reset() {
+  Parser::reset();
+  _frames.clear();
+  if (_preparingReparse) {
+    // Reused nodes of the previous trees keep their ordinals.
+    _tracker.reserveOrdinals(_previousTrees.getOrdinalCount());
+  } else {
+    _oldTree = nullptr;
+    _previousTrees.reset();
+  }
+}
+
+void IncrementalParser::enterRule(ParserRuleContext *localctx, size_t state, size_t ruleIndex) {
+  pushFrame();
+  Parser::enterRule(localctx, state, ruleIndex);
+}
+
+void IncrementalParser::exitRule() {
+  ParserRuleContext *ctx = _ctx;
+  Parser::exitRule();
+  popFrame(ctx);
+}
+
+void IncrementalParser::enterRecursionRule(ParserRuleContext *localctx, size_t state, size_t ruleIndex,
+                                           int precedence) {
+  pushFrame();
+  Parser::enterRecursionRule(localctx, state, ruleIndex, precedence);
+}
+
+void IncrementalParser::pushNewRecursionContext(ParserRuleContext *localctx, size_t state, size_t ruleIndex) {
+  ParserRuleContext *previous = _ctx;
+  Parser::pushNewRecursionContext(localctx, state, ruleIndex);
+
+  // The previous context is complete now. The new one starts at the same token and has the same frame.
+  if (!_frames.empty()) {
+    completeContext(previous, _incrementalInput->getMaxLookaheadIndex(), _frames.back().syntaxErrors);
+  }
+}
+
+void IncrementalParser::unrollRecursionContexts(ParserRuleContext *parentctx) {
+  ParserRuleContext *ctx = _ctx;
+  Parser::unrollRecursionContexts(parentctx);
+  popFrame(ctx);
+}
+
+IncrementalParserRuleContext* IncrementalParser::findReusableContext(size_t ruleIndex) {
+  if (_oldTree == nullptr || !_buildParseTrees || getIncrementalInput() == nullptr
+      || _errHandler->inErrorRecoveryMode(this)) {
+    return nullptr;
+  }
+
+  // Inserted tokens are not in the old tree. All other tokens were taken over from the old token stream,
+  // so the old tree sees their new indices (and the removed tokens got the index of the change).
+  size_t index = _input->LT(1)->getTokenIndex();
+  bool beforeChange = index < _change.start;
+  if (!beforeChange && index < _change.start + _change.inserted) {
+    return nullptr;
+  }
+
+  // Descend along the contexts containing that token, outermost first.
+  ParseTree *node = _oldTree;
+  while (node != nullptr && node->getTreeType() == ParseTreeType::RULE) {
+    ParserRuleContext *ctx = static_cast<ParserRuleContext *>(node);
+    size_t start = startIndex(ctx);
+    if (start == INVALID_INDEX || start > index) {
+      break;
+    }
+
+    if (start == index && ctx->getRuleIndexOrTokenType() == ruleIndex) {
+      IncrementalParserRuleContext *candidate = dynamic_cast<IncrementalParserRuleContext *>(ctx);
+      if (candidate != nullptr && isReusable(candidate, beforeChange)) {
+        return candidate;
+      }
+    }
+    node = childAt(ctx, index);
+  }
+
+  return nullptr;
+}
+
+void IncrementalParser::reuse(IncrementalParserRuleContext *ctx) {
+  // Empty contexts at the start of the subtree stop at the token before it, which may have changed.
+  Token *previous = _input->LT(-1);
+  std::vector<ParserRuleContext *> leading = { ctx };
+  while (!leading.empty()) {
+    ParserRuleContext *context = leading.back();
+    leading.pop_back();
+    if (context->stop != context->start && context->stop->getTokenIndex() <= context->start->getTokenIndex()) {
+      context->stop = previous;
+    }
+    for (auto child : context->children) {
+      if (child->getTreeType() != ParseTreeType::RULE) {
+        break;
+      }
+      ParserRuleContext *childContext = static_cast<ParserRuleContext *>(child);
+      if (childContext->start != ctx->start) {
+        break;
+      }
+      leading.push_back(childContext);
+    }
+  }
+
+  size_t stop = ctx->stop->getTokenIndex();
+  if (ctx->stop->getType() == Token::EOF) {
+    _input->seek(stop);
+    _matchedEOF = true;
+  } else {
+    _input->seek(stop + 1);
+  }
+
+  ctx->parent = _ctx;
+  if (_ctx != nullptr) {
+    _ctx->addChild(ctx);
+  }
+  size_t lookahead = ctx->maxLookaheadToken->getTokenIndex();
+  _incrementalInput->setMaxLookaheadIndex(std::max(_incrementalInput->getMaxLookaheadIndex(), lookahead));
+  ++_reusedContexts;
+}
+
+IncrementalTokenStream* IncrementalParser::getIncrementalInput() {
+  if (_input != _checkedInput) {
+    _checkedInput = _input;
+    _incrementalInput = dynamic_cast<IncrementalTokenStream *>(_input);
+  }
+  return _incrementalInput;
+}
+
+void IncrementalParser::pushFrame() {
+  if (getIncrementalInput() == nullptr) {
+    return;
+  }
+
+  _frames.push_back({ _incrementalInput->getMaxLookaheadIndex(), _syntaxErrors });
+  _incrementalInput->setMaxLookaheadIndex(0);
+}
+
+void IncrementalParser::popFrame(ParserRuleContext *ctx) {
+  if (_frames.empty()) {
+    return;
+  }
+
+  Frame frame = _frames.back();
+  _frames.pop_back();
+
+  size_t lookahead = _incrementalInput->getMaxLookaheadIndex();
+  completeContext(ctx, lookahead, frame.syntaxErrors);
+  _incrementalInput->setMaxLookaheadIndex(std::max(frame.lookahead, lookahead));
+}
+
+void IncrementalParser::completeContext(ParserRuleContext *ctx, size_t lookahead, size_t syntaxErrors) {
+  IncrementalParserRuleContext *context = dynamic_cast<IncrementalParserRuleContext *>(ctx);
+  if (context == nullptr) {
+    return;
+  }
+
+  if (ctx->stop != nullptr && ctx->stop->getTokenIndex() != INVALID_INDEX) {
+    lookahead = std::max(lookahead, ctx->stop->getTokenIndex());
+  }
+  context->maxLookaheadToken = _input->get(lookahead);
+  context->containsErrors = _syntaxErrors != syntaxErrors || ctx->exception != nullptr;
+  for (auto child : ctx->children) {
+    if (child->getTreeType() == ParseTreeType::ERROR) {
+      context->containsErrors = true;
+      break;
+    }
+  }
+}
+
+bool IncrementalParser::isReusable(IncrementalParserRuleContext *candidate, bool beforeChange) {
+  if (candidate->containsErrors || candidate->exception != nullptr || candidate->stop == nullptr
+      || candidate->maxLookaheadToken == nullptr) {
+    return false;
+  }
+
+  // The old tree must have been parsed from the tokens the new stream took over.
+  if (candidate->start != _input->LT(1)) {
+    return false;
+  }
+
+  // Empty contexts are cheap to parse, and their stop token is outside of them.
+  if (candidate->stop != candidate->start
+      && candidate->stop->getTokenIndex() <= candidate->start->getTokenIndex()) {
+    return false;
+  }
+
+  // All tokens the context depends on must be unchanged. Contexts after the change only look further ahead.
+  if (beforeChange && candidate->maxLookaheadToken->getTokenIndex() >= _change.start) {
+    return false;
+  }
+
+  // The parse of a rule depends on its invocation stack (e.g. for the full context prediction).
+  if (candidate->invokingState != getState()) {
+    return false;
+  }
+  ParseTree *oldParent = candidate->parent;
+  ParseTree *newParent = _ctx;
+  while (oldParent != nullptr && newParent != nullptr) {
+    if (static_cast<RuleContext *>(oldParent)->invokingState != static_cast<RuleContext *>(newParent)->invokingState) {
+      return false;
+    }
+    oldParent = oldParent->parent;
+    newParent = newParent->parent;
+  }
+  return oldParent == nullptr && newParent == nullptr;
+}
@@ -0,0 +1,114 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "IncrementalLexer.h"
+#include "IncrementalParserRuleContext.h"
+#include "Parser.h"
+
+namespace antlr4 {
+
+  class IncrementalTokenStream;
+
+  /// The base class of parsers generated with the incremental option (options {incremental=true;}), which
+  /// can reparse an edited input by reusing the unchanged subtrees of the previous parse tree.
+  ///
+  /// While parsing from an IncrementalTokenStream, the parser records for every rule context (see
+  /// IncrementalParserRuleContext) the furthest token it looked at and whether a syntax error occurred in it.
+  /// To reparse, create the new token stream from the previous one and the token change (as returned by
+  /// IncrementalLexer::relex(), see IncrementalTokenStream), pass it, the previous tree and the change to
+  /// setReparseInput() and call the start rule again. Whenever a rule is
+  /// entered at a token which was not changed, the parser looks for a context of the same rule in the old
+  /// tree which started at the same token, in the same invocation stack. If all tokens it looked at are
+  /// unchanged too, the context is moved into the new tree and the parser continues after it.
+  ///
+  /// Notes:
+  ///   - Contexts of left recursive rules and of rules with arguments are never reused (but the
+  ///     contexts in them are).
+  ///   - Actions, predicates and parse listeners are not executed for reused subtrees. Don't use the
+  ///     incremental option with grammars whose parse depends on them.
+  ///   - Reused subtrees are moved as they are: the new token stream takes over the unchanged tokens of the
+  ///     previous one, so their nodes keep pointing to valid tokens. Creating that stream still takes one
+  ///     pass over the token pointers, like relexing does, but nothing depends on the size of the tree.
+  ///   - Contexts are reused one by one, so a reparse visits every context of a list which isn't reused
+  ///     as a whole (e.g. each statement at the top level of a file).
+  ///   - The memory of old trees is kept until the parser is reset or gets a new input by other means
+  ///     than setReparseInput().
+  class ANTLR4CPP_PUBLIC IncrementalParser : public Parser {
+  public:
+    IncrementalParser(TokenStream *input);
+    virtual ~IncrementalParser();
+
+    /// Prepares a reparse from newInput, which must be an IncrementalTokenStream to reuse anything.
+    /// The tokens from change.start to change.start + change.inserted in newInput replace the tokens
+    /// from change.start to change.start + change.removed in the stream oldTree was parsed from. Nothing
+    /// is reused unless newInput was created from that stream with the same change.
+    /// The nodes of oldTree (and of all trees created since the last reset) stay valid until the next reset,
+    /// but reused subtrees are moved to the new tree.
+    virtual void setReparseInput(TokenStream *newInput, ParserRuleContext *oldTree,
+                                 const IncrementalLexer::TokenChange &change);
+
+    /// The number of contexts reused since the last call to setReparseInput().
+    size_t getReusedContextCount() const;
+
+    virtual void reset() override;
+
+    virtual void enterRule(ParserRuleContext *localctx, size_t state, size_t ruleIndex) override;
+    virtual void exitRule() override;
+
+    using Parser::enterRecursionRule;
+    virtual void enterRecursionRule(ParserRuleContext *localctx, size_t state, size_t ruleIndex,
+                                    int precedence) override;
+    virtual void pushNewRecursionContext(ParserRuleContext *localctx, size_t state, size_t ruleIndex) override;
+    virtual void unrollRecursionContexts(ParserRuleContext *parentctx) override;
+
+  protected:
+    /// Called by the generated rule functions before a new context is created. Returns a context of the
+    /// previous tree which has been moved to the current position, or nullptr if none can be reused.
+    template<typename T>
+    T* reuseContext(size_t ruleIndex) {
+      IncrementalParserRuleContext *candidate = findReusableContext(ruleIndex);
+      if (candidate == nullptr) {
+        return nullptr;
+      }
+
+      // Labeled alternatives create subclasses of the rule's context class.
+      T *result = dynamic_cast<T *>(candidate);
+      if (result != nullptr) {
+        reuse(candidate);
+      }
+      return result;
+    }
+
+    virtual IncrementalParserRuleContext* findReusableContext(size_t ruleIndex);
+
+    /// Moves the context into the current one and continues after its stop token.
+    virtual void reuse(IncrementalParserRuleContext *ctx);
+
+  private:
+    struct Frame {
+      size_t lookahead; // The lookahead of the enclosing rule before this one was entered.
+      size_t syntaxErrors;
+    };
+
+    std::vector<Frame> _frames;
+    tree::ParseTreeTracker _previousTrees;
+    ParserRuleContext *_oldTree;
+    IncrementalLexer::TokenChange _change;
+    bool _preparingReparse;
+    size_t _reusedContexts;
+
+    TokenStream *_checkedInput;
+    IncrementalTokenStream *_incrementalInput;
+
+    IncrementalTokenStream* getIncrementalInput();
+    void pushFrame();
+    void popFrame(ParserRuleContext *ctx);
+    void completeContext(ParserRuleContext *ctx, size_t lookahead, size_t syntaxErrors);
+    bool isReusable(IncrementalParserRuleContext *candidate, bool beforeChange);
+  };
+
+} // namespace antlr4
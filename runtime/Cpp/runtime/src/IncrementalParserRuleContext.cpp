@@ -0,0 +1,16 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "IncrementalParserRuleContext.h"
+
+using namespace antlr4;
+
+IncrementalParserRuleContext::IncrementalParserRuleContext()
+  : maxLookaheadToken(nullptr), containsErrors(false) {
+}
+
+IncrementalParserRuleContext::IncrementalParserRuleContext(ParserRuleContext *parent, size_t invokingStateNumber)
+  : ParserRuleContext(parent, invokingStateNumber), maxLookaheadToken(nullptr), containsErrors(false) {
+}
@@ -0,0 +1,27 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "ParserRuleContext.h"
+
+namespace antlr4 {
+
+  /// The base class of the rule contexts of a parser generated with the incremental option. It records
+  /// what IncrementalParser needs to decide whether the context can be reused in a later parse run.
+  class ANTLR4CPP_PUBLIC IncrementalParserRuleContext : public ParserRuleContext {
+  public:
+    /// The furthest token the parser looked at while parsing this context, including the lookahead of all
+    /// predictions made in it. nullptr if the context was not (yet) completed by an IncrementalParser.
+    Token *maxLookaheadToken;
+
+    /// Set if a syntax error was reported while parsing this context.
+    bool containsErrors;
+
+    IncrementalParserRuleContext();
+    IncrementalParserRuleContext(ParserRuleContext *parent, size_t invokingStateNumber);
+  };
+
+} // namespace antlr4
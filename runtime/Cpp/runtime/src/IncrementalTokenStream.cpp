@@ -0,0 +1,87 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "CommonToken.h"
+#include "Exceptions.h"
+#include "ListTokenSource.h"
+
+#include "IncrementalTokenStream.h"
+
+using namespace antlr4;
+
+IncrementalTokenStream::IncrementalTokenStream(TokenSource *tokenSource)
+  : IncrementalTokenStream(tokenSource, Token::DEFAULT_CHANNEL) {
+}
+
+IncrementalTokenStream::IncrementalTokenStream(TokenSource *tokenSource, size_t channel)
+  : CommonTokenStream(tokenSource, channel), _maxLookaheadIndex(0) {
+}
+
+IncrementalTokenStream::IncrementalTokenStream(IncrementalTokenStream &previous,
+  const std::vector<std::unique_ptr<Token>> &tokens, const IncrementalLexer::TokenChange &change)
+  : CommonTokenStream(nullptr, previous.channel), _maxLookaheadIndex(0) {
+  previous.fill();
+  std::vector<std::unique_ptr<Token>> &oldTokens = previous._tokens;
+  size_t changeEnd = change.start + change.removed;
+  if (changeEnd > oldTokens.size() || tokens.size() != oldTokens.size() - change.removed + change.inserted) {
+    throw IllegalArgumentException("The token change doesn't match the previous token stream.");
+  }
+
+  std::vector<std::unique_ptr<Token>> newTokens;
+  newTokens.reserve(tokens.size());
+  for (size_t i = 0; i < change.start; ++i) {
+    newTokens.push_back(std::move(oldTokens[i]));
+  }
+  for (size_t i = change.start; i < change.start + change.inserted; ++i) {
+    newTokens.emplace_back(new CommonToken(tokens[i].get()));
+  }
+
+  // The tokens behind the change moved in the input.
+  for (size_t i = changeEnd; i < oldTokens.size(); ++i) {
+    CommonToken *token = dynamic_cast<CommonToken *>(oldTokens[i].get());
+    if (token == nullptr) {
+      throw IllegalStateException("incremental reparsing requires CommonToken instances");
+    }
+    Token *moved = tokens[i - change.removed + change.inserted].get();
+    token->setStartIndex(moved->getStartIndex());
+    token->setStopIndex(moved->getStopIndex());
+    token->setLine(moved->getLine());
+    token->setCharPositionInLine(moved->getCharPositionInLine());
+    newTokens.push_back(std::move(oldTokens[i]));
+  }
+
+  // The previous tree looks up contexts by their start token index. The removed tokens get the index of the
+  // change, so that the indices in the previous tree stay ordered.
+  for (size_t i = change.start; i < changeEnd; ++i) {
+    WritableToken *token = dynamic_cast<WritableToken *>(oldTokens[i].get());
+    if (token != nullptr) {
+      token->setTokenIndex(change.start);
+    }
+  }
+
+  // Fetching sets the new token indices.
+  _reparseSource.reset(new ListTokenSource(std::move(newTokens), previous.getSourceName()));
+  setTokenSource(_reparseSource.get());
+  fill();
+}
+
+IncrementalTokenStream::~IncrementalTokenStream() {
+}
+
+Token* IncrementalTokenStream::LT(ssize_t k) {
+  Token *token = CommonTokenStream::LT(k);
+  if (k > 0 && token != nullptr && token->getTokenIndex() != INVALID_INDEX) {
+    _maxLookaheadIndex = std::max(_maxLookaheadIndex, token->getTokenIndex());
+  }
+  return token;
+}
+
+size_t IncrementalTokenStream::getMaxLookaheadIndex() const {
+  return _maxLookaheadIndex;
+}
+
+void IncrementalTokenStream::setMaxLookaheadIndex(size_t index) {
+  _maxLookaheadIndex = index;
+}
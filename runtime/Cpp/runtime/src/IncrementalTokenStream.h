@@ -0,0 +1,49 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "CommonTokenStream.h"
+#include "IncrementalLexer.h"
+
+namespace antlr4 {
+
+  class ListTokenSource;
+
+  /// A CommonTokenStream which records the highest index of all tokens returned by LT() (and hence LA()),
+  /// which includes the lookahead of the prediction. IncrementalParser uses this to find out which tokens
+  /// a rule context depends on.
+  class ANTLR4CPP_PUBLIC IncrementalTokenStream : public CommonTokenStream {
+  public:
+    IncrementalTokenStream(TokenSource *tokenSource);
+    IncrementalTokenStream(TokenSource *tokenSource, size_t channel);
+
+    /// Creates the stream for a reparse (see IncrementalParser::setReparseInput()). previous is the stream the
+    /// previous tree was parsed from, tokens are the tokens of the edited input (usually
+    /// IncrementalLexer::getTokens()) and change is the difference between them (as returned by
+    /// IncrementalLexer::relex()). Only the changed tokens are copied. All other tokens are taken over from
+    /// previous and updated to their new index and position, so subtrees reused from the previous tree keep
+    /// pointing to valid tokens.
+    ///
+    /// previous must not be used afterwards, but must stay alive until the reparse is done: the parts of
+    /// the previous tree which are not reused still refer to the removed tokens, which it keeps.
+    IncrementalTokenStream(IncrementalTokenStream &previous, const std::vector<std::unique_ptr<Token>> &tokens,
+                           const IncrementalLexer::TokenChange &change);
+    virtual ~IncrementalTokenStream();
+
+    virtual Token* LT(ssize_t k) override;
+
+    /// The highest index of a token looked at since the last call to setMaxLookaheadIndex() (0 initially).
+    size_t getMaxLookaheadIndex() const;
+    void setMaxLookaheadIndex(size_t index);
+
+  protected:
+    size_t _maxLookaheadIndex;
+
+  private:
+    std::unique_ptr<ListTokenSource> _reparseSource; // Only for streams created for a reparse.
+  };
+
+} // namespace antlr4
@@ -12,6 +12,7 @@ InterpreterRuleContext::InterpreterRuleContext() : ParserRuleContext() {
 
 InterpreterRuleContext::InterpreterRuleContext(ParserRuleContext *parent, size_t invokingStateNumber, size_t ruleIndex)
   : ParserRuleContext(parent, invokingStateNumber), _ruleIndex(ruleIndex) {
+  setRuleIndexOrTokenType(ruleIndex);
 }
 
 size_t InterpreterRuleContext::getRuleIndex() const {
@@ -31,9 +31,12 @@ Lexer::Lexer(CharStream *input) : Recognizer(), _input(input) {
 
 void Lexer::reset() {
   // wack Lexer state variables
-  _input->seek(0); // rewind the input
+  if (_input != nullptr) {
+    _input->seek(0); // rewind the input
+  }
 
   _syntaxErrors = 0;
+  _errorStartCharIndex = INVALID_INDEX;
   token.reset();
   type = Token::INVALID_TYPE;
   channel = Token::DEFAULT_CHANNEL;
@@ -64,6 +67,7 @@ std::unique_ptr<Token> Lexer::nextToken() {
   while (true) {
   outerContinue:
     if (hitEOF) {
+      reportUnrecognizedChars();
       emitEOF();
       return std::move(token);
     }
@@ -84,6 +88,14 @@ std::unique_ptr<Token> Lexer::nextToken() {
         recover(e);
         ttype = SKIP;
       }
+      if (_exceptionFreeRecovery) {
+        if (ttype == Token::INVALID_TYPE) { // No viable alternative.
+          skipUnrecognizedChar();
+          ttype = SKIP;
+        } else {
+          reportUnrecognizedChars();
+        }
+      }
       if (_input->LA(1) == EOF) {
         hitEOF = true;
       }
@@ -251,6 +263,46 @@ void Lexer::notifyListeners(const LexerNoViableAltException & /*e*/) {
   listener.syntaxError(this, nullptr, tokenStartLine, tokenStartCharPositionInLine, msg, std::current_exception());
 }
 
+void Lexer::setExceptionFreeRecovery(bool enable) {
+  _exceptionFreeRecovery = enable;
+}
+
+bool Lexer::isExceptionFreeRecovery() const {
+  return _exceptionFreeRecovery;
+}
+
+void Lexer::skipUnrecognizedChar() {
+  if (_errorStartCharIndex == INVALID_INDEX) {
+    _errorStartCharIndex = tokenStartCharIndex;
+    _errorStartLine = tokenStartLine;
+    _errorStartCharPositionInLine = tokenStartCharPositionInLine;
+  }
+  _errorStopCharIndex = _input->index();
+
+  recover(LexerNoViableAltException(this, _input, tokenStartCharIndex, nullptr));
+
+  // Skip the following characters too, if the DFA already knows that no token starts with them.
+  if (getInterpreter<atn::LexerATNSimulator>()->skipUnmatchableChars(_input, mode) > 0) {
+    _errorStopCharIndex = _input->index() - 1;
+  }
+}
+
+void Lexer::reportUnrecognizedChars() {
+  if (_errorStartCharIndex == INVALID_INDEX) {
+    return;
+  }
+
+  ++_syntaxErrors;
+  std::string text = _input->getText(misc::Interval(_errorStartCharIndex, _errorStopCharIndex));
+  std::string msg = std::string("token recognition error at: '") + getErrorDisplay(text) + std::string("'");
+
+  LexerNoViableAltException e(this, _input, _errorStartCharIndex, nullptr);
+  _errorStartCharIndex = INVALID_INDEX;
+
+  ProxyErrorListener &listener = getErrorListenerDispatch();
+  listener.syntaxError(this, nullptr, _errorStartLine, _errorStartCharPositionInLine, msg, std::make_exception_ptr(e));
+}
+
 std::string Lexer::getErrorDisplay(const std::string &s) {
   std::stringstream ss;
   for (auto c : s) {
@@ -283,6 +335,11 @@ size_t Lexer::getNumberOfSyntaxErrors() {
 
 void Lexer::InitializeInstanceFields() {
   _syntaxErrors = 0;
+  _exceptionFreeRecovery = false;
+  _errorStartCharIndex = INVALID_INDEX;
+  _errorStopCharIndex = INVALID_INDEX;
+  _errorStartLine = 0;
+  _errorStartCharPositionInLine = 0;
   token = nullptr;
   _factory = CommonTokenFactory::DEFAULT;
   tokenStartCharIndex = INVALID_INDEX;
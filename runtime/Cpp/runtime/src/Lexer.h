@@ -170,6 +170,15 @@ namespace antlr4 {
 
     virtual std::string getErrorDisplay(const std::string &s);
 
+    /// With exception free recovery, the LexerATNSimulator doesn't throw a LexerNoViableAltException when no token
+    /// matches the input, which costs a lot when large parts of the input (e.g. binary data) cannot be lexed.
+    /// nextToken() calls recover() and then skips the following characters no token can start with, and reports
+    /// a contiguous run of unrecognized characters as a single error once the next token matched or the end of
+    /// the input is reached. Lexers generated with the
+    /// exceptionFree option enable it in their constructor. The default is false.
+    void setExceptionFreeRecovery(bool enable);
+    bool isExceptionFreeRecovery() const;
+
     /// Lexers can normally match any char in it's vocabulary after matching
     /// a token, so do the easy thing and just kill a character and hope
     /// it all works out.  You can instead use the rule invocation stack
@@ -190,6 +199,16 @@ namespace antlr4 {
 
   private:
     size_t _syntaxErrors;
+    bool _exceptionFreeRecovery;
+
+    // The run of unrecognized characters which hasn't been reported yet (exception free recovery only).
+    size_t _errorStartCharIndex;
+    size_t _errorStopCharIndex;
+    size_t _errorStartLine;
+    size_t _errorStartCharPositionInLine;
+
+    void skipUnrecognizedChar();
+    void reportUnrecognizedChars();
     void InitializeInstanceFields();
   };
 
@@ -61,7 +61,7 @@ size_t ListTokenSource::getLine() const {
 CharStream *ListTokenSource::getInputStream() {
   if (i < tokens.size()) {
     return tokens[i]->getInputStream();
-  } else if (!tokens.empty()) {
+  } else if (!tokens.empty() && tokens.back() != nullptr) { // The tokens are moved out when consumed.
     return tokens.back()->getInputStream();
   }
 
@@ -0,0 +1,122 @@
+﻿/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#ifdef _WIN32
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include "Exceptions.h"
+#include "support/StringUtils.h"
+
+#include "MemoryMappedFileStream.h"
+
+using namespace antlr4;
+
+MemoryMappedFileStream::MemoryMappedFileStream(const std::string &fileName) : _mapping(nullptr), _mappingSize(0) {
+  loadFromFile(fileName);
+}
+
+MemoryMappedFileStream::~MemoryMappedFileStream() {
+  unmap();
+}
+
+void MemoryMappedFileStream::loadFromFile(const std::string &fileName) {
+  unmap();
+  load(nullptr, 0);
+
+  _fileName = fileName;
+  if (_fileName.empty()) {
+    return;
+  }
+
+#ifdef _WIN32
+  HANDLE file = CreateFileW(antlrcpp::s2ws(fileName).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw IOException("cannot open file " + fileName);
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize)) {
+    CloseHandle(file);
+    throw IOException("cannot determine the size of file " + fileName);
+  }
+
+  if (fileSize.QuadPart > 0) {
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+      _mapping = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      CloseHandle(mapping); // The view keeps the mapping alive.
+    }
+    if (_mapping == nullptr) {
+      CloseHandle(file);
+      throw IOException("cannot map file " + fileName);
+    }
+    _mappingSize = static_cast<size_t>(fileSize.QuadPart);
+  }
+  CloseHandle(file);
+#else
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw IOException("cannot open file " + fileName);
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    throw IOException("cannot determine the size of file " + fileName);
+  }
+
+  if (info.st_size > 0) {
+    void *mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      close(fd);
+      throw IOException("cannot map file " + fileName);
+    }
+    _mapping = mapping;
+    _mappingSize = static_cast<size_t>(info.st_size);
+    madvise(_mapping, _mappingSize, MADV_SEQUENTIAL);
+  }
+  close(fd); // The mapping stays valid.
+#endif
+
+  try {
+    load(static_cast<const char *>(_mapping), _mappingSize);
+  } catch (...) {
+    unmap();
+    load(nullptr, 0);
+    throw;
+  }
+}
+
+std::string MemoryMappedFileStream::getSourceName() const {
+  return _fileName;
+}
+
+void MemoryMappedFileStream::unmap() {
+  if (_mapping == nullptr) {
+    return;
+  }
+
+#ifdef _WIN32
+  UnmapViewOfFile(_mapping);
+#else
+  munmap(_mapping, _mappingSize);
+#endif
+
+  _mapping = nullptr;
+  _mappingSize = 0;
+}
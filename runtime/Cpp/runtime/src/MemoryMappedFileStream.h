@@ -0,0 +1,38 @@
+﻿/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "UTF8CharStream.h"
+
+namespace antlr4 {
+
+  /// A UTF8CharStream over a memory mapped file. The file content is never copied, so the memory needed
+  /// for lexing is close to the file size (and mostly page cache), instead of 4 bytes per character
+  /// plus a copy of the file, as with ANTLRFileStream.
+  class ANTLR4CPP_PUBLIC MemoryMappedFileStream : public UTF8CharStream {
+  protected:
+    std::string _fileName; // UTF-8 encoded file name.
+
+  public:
+    // Assumes a file name encoded in UTF-8 and file content in the same encoding (with or w/o BOM).
+    // Throws IOException if the file cannot be mapped.
+    MemoryMappedFileStream(const std::string &fileName);
+    MemoryMappedFileStream(const MemoryMappedFileStream &) = delete;
+    virtual ~MemoryMappedFileStream();
+
+    MemoryMappedFileStream& operator = (const MemoryMappedFileStream &) = delete;
+
+    virtual void loadFromFile(const std::string &fileName);
+    virtual std::string getSourceName() const override;
+
+  protected:
+    void *_mapping;
+    size_t _mappingSize;
+
+    virtual void unmap();
+  };
+
+} // namespace antlr4
@@ -4,6 +4,7 @@
  */
 
 #include "Parser.h"
+#include "atn/ATNConfigSet.h"
 
 #include "NoViableAltException.h"
 
@@ -17,12 +18,15 @@ NoViableAltException::NoViableAltException(Parser *recognizer)
 NoViableAltException::NoViableAltException(Parser *recognizer, TokenStream *input,Token *startToken,
   Token *offendingToken, atn::ATNConfigSet *deadEndConfigs, ParserRuleContext *ctx, bool deleteConfigs)
   : RecognitionException("No viable alternative", recognizer, input, ctx, offendingToken),
-    _deadEndConfigs(deadEndConfigs), _startToken(startToken), _deleteConfigs(deleteConfigs) {
+    _startToken(startToken) {
+  if (deleteConfigs) {
+    _deadEndConfigs.reset(deadEndConfigs);
+  } else {
+    _deadEndConfigs.reset(deadEndConfigs, [](atn::ATNConfigSet *) {});
+  }
 }
 
 NoViableAltException::~NoViableAltException() {
-  if (_deleteConfigs)
-    delete _deadEndConfigs;
 }
 
 Token* NoViableAltException::getStartToken() const {
@@ -30,5 +34,5 @@ Token* NoViableAltException::getStartToken() const {
 }
 
 atn::ATNConfigSet* NoViableAltException::getDeadEndConfigs() const {
-  return _deadEndConfigs;
+  return _deadEndConfigs.get();
 }
@@ -97,6 +97,7 @@ void Parser::reset() {
   _precedenceStack.clear();
   _precedenceStack.push_back(0);
   _ctx = nullptr;
+  _errorRecovered = false;
   _tracker.reset();
 
   atn::ATNSimulator *interpreter = getInterpreter<atn::ParserATNSimulator>();
@@ -115,7 +116,7 @@ Token* Parser::match(size_t ttype) {
     consume();
   } else {
     t = _errHandler->recoverInline(this);
-    if (_buildParseTrees && t->getTokenIndex() == INVALID_INDEX) {
+    if (_buildParseTrees && t != nullptr && t->getTokenIndex() == INVALID_INDEX) {
       // we must have conjured up a new token during single token insertion
       // if it's not the current symbol
       _ctx->addChild(createErrorNode(t));
@@ -131,7 +132,7 @@ Token* Parser::matchWildcard() {
     consume();
   } else {
     t = _errHandler->recoverInline(this);
-    if (_buildParseTrees && t->getTokenIndex() == INVALID_INDEX) {
+    if (_buildParseTrees && t != nullptr && t->getTokenIndex() == INVALID_INDEX) {
       // we must have conjured up a new token during single token insertion
       // if it's not the current symbol
       _ctx->addChild(createErrorNode(t));
@@ -332,8 +333,9 @@ void Parser::addContextToParseTree() {
   parent->addChild(_ctx);
 }
 
-void Parser::enterRule(ParserRuleContext *localctx, size_t state, size_t /*ruleIndex*/) {
+void Parser::enterRule(ParserRuleContext *localctx, size_t state, size_t ruleIndex) {
   setState(state);
+  localctx->setRuleIndexOrTokenType(ruleIndex);
   _ctx = localctx;
   _ctx->start = _input->LT(1);
   if (_buildParseTrees) {
@@ -387,8 +389,9 @@ void Parser::enterRecursionRule(ParserRuleContext *localctx, size_t ruleIndex) {
   enterRecursionRule(localctx, getATN().ruleToStartState[ruleIndex]->stateNumber, ruleIndex, 0);
 }
 
-void Parser::enterRecursionRule(ParserRuleContext *localctx, size_t state, size_t /*ruleIndex*/, int precedence) {
+void Parser::enterRecursionRule(ParserRuleContext *localctx, size_t state, size_t ruleIndex, int precedence) {
   setState(state);
+  localctx->setRuleIndexOrTokenType(ruleIndex);
   _precedenceStack.push_back(precedence);
   _ctx = localctx;
   _ctx->start = _input->LT(1);
@@ -397,7 +400,8 @@ void Parser::enterRecursionRule(ParserRuleContext *localctx, size_t state, size_
   }
 }
 
-void Parser::pushNewRecursionContext(ParserRuleContext *localctx, size_t state, size_t /*ruleIndex*/) {
+void Parser::pushNewRecursionContext(ParserRuleContext *localctx, size_t state, size_t ruleIndex) {
+  localctx->setRuleIndexOrTokenType(ruleIndex);
   ParserRuleContext *previous = _ctx;
   previous->parent = localctx;
   previous->invokingState = state;
@@ -634,6 +638,30 @@ tree::ErrorNode *Parser::createErrorNode(Token *t) {
   return _tracker.createInstance<tree::ErrorNodeImpl>(t);
 }
 
+void Parser::setExceptionFreeRecovery(bool enable) {
+  _exceptionFreeRecovery = enable;
+}
+
+bool Parser::isExceptionFreeRecovery() const {
+  return _exceptionFreeRecovery;
+}
+
+void Parser::setStoreRecoveredExceptions(bool store) {
+  _storeRecoveredExceptions = store;
+}
+
+bool Parser::getStoreRecoveredExceptions() const {
+  return _storeRecoveredExceptions;
+}
+
+void Parser::recoverFromError(const RecognitionException &e, std::exception_ptr exception) {
+  // The same steps as in the catch clause of a generated rule function.
+  _errHandler->reportError(this, e);
+  _ctx->exception = exception;
+  _errHandler->recover(this, exception);
+  _errorRecovered = true;
+}
+
 void Parser::InitializeInstanceFields() {
   _errHandler = std::make_shared<DefaultErrorStrategy>();
   _precedenceStack.clear();
@@ -644,5 +672,8 @@ void Parser::InitializeInstanceFields() {
   _input = nullptr;
   _tracer = nullptr;
   _ctx = nullptr;
+  _exceptionFreeRecovery = false;
+  _storeRecoveredExceptions = false;
+  _errorRecovered = false;
 }
 
@@ -272,7 +272,7 @@ namespace antlr4 {
     /// <seealso cref="#_ctx"/> get the current context.
     virtual void enterRule(ParserRuleContext *localctx, size_t state, size_t ruleIndex);
 
-    void exitRule();
+    virtual void exitRule();
 
     virtual void enterOuterAlt(ParserRuleContext *localctx, size_t altNum);
 
@@ -401,6 +401,36 @@ namespace antlr4 {
        */
     tree::ErrorNode *createErrorNode(Token *t);
 
+    /// With exception free recovery, syntax errors which the error strategy cannot repair inline are not thrown
+    /// as RecognitionException. The component which detects the error (the error strategy, the ATN simulator or
+    /// a predicate check) calls recoverFromError() instead, and the rule function returns after checking
+    /// takeRecoveredError(). Parsers generated with the exceptionFree option enable it in their constructor and
+    /// contain these checks. It must not be enabled for other generated parsers. The default is false.
+    ///
+    /// Error strategies which throw (like BailErrorStrategy) still work in this mode.
+    void setExceptionFreeRecovery(bool enable);
+    bool isExceptionFreeRecovery() const;
+
+    /// With exception free recovery, an error is only copied into an std::exception_ptr (for
+    /// ParserRuleContext::exception, the error listeners and ANTLRErrorStrategy::recover()) if this is enabled.
+    /// Creating one costs an allocation, and with some standard libraries (e.g. libc++) a throw and catch, which is
+    /// what exception free recovery avoids. Without it ParserRuleContext::exception stays null for recovered errors,
+    /// error listeners get a null exception pointer and BailErrorStrategy throws its ParseCancellationException
+    /// without a nested exception. The default is false.
+    void setStoreRecoveredExceptions(bool store);
+    bool getStoreRecoveredExceptions() const;
+
+    /// Handles a syntax error like the catch clause of a generated rule function, but without throwing it:
+    /// reports it to the error strategy, stores it in the current context (see setStoreRecoveredExceptions())
+    /// and lets the error strategy recover. Afterwards takeRecoveredError() returns true.
+    template<typename T>
+    void recoverFromError(const T &e) {
+      recoverFromError(e, _storeRecoveredExceptions ? std::make_exception_ptr(e) : nullptr);
+    }
+
+    /// The same, for an exception whose concrete type is only known by the exception pointer (which can be null).
+    virtual void recoverFromError(const RecognitionException &e, std::exception_ptr exception);
+
   protected:
     /// The ParserRuleContext object for the currently executing rule.
     /// This is always non-null during the parsing process.
@@ -442,8 +472,21 @@ namespace antlr4 {
     /** Indicates parser has match()ed EOF token. See {@link #exitRule()}. */
     bool _matchedEOF;
 
+    /// Set by recoverFromError(), see takeRecoveredError().
+    bool _errorRecovered;
+
     virtual void addContextToParseTree();
 
+    /// For exception free recovery: returns true if an error was recovered from since the last call, in which
+    /// case the current rule function must return.
+    bool takeRecoveredError() {
+      if (!_errorRecovered) {
+        return false;
+      }
+      _errorRecovered = false;
+      return true;
+    }
+
     // All rule contexts created during a parse run. This is cleared when calling reset().
     tree::ParseTreeTracker _tracker;
 
@@ -461,6 +504,9 @@ namespace antlr4 {
     /// other parser methods.
     TraceListener *_tracer;
 
+    bool _exceptionFreeRecovery;
+    bool _storeRecoveredExceptions;
+
     void InitializeInstanceFields();
   };
 
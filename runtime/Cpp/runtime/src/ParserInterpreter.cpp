@@ -66,6 +66,7 @@ void ParserInterpreter::reset() {
   Parser::reset();
   _overrideDecisionReached = false;
   _overrideDecisionRoot = nullptr;
+  _errorTokens.clear();
 }
 
 const atn::ATN& ParserInterpreter::getATN() const {
@@ -128,7 +129,7 @@ ParserRuleContext* ParserInterpreter::parse(size_t startRuleIndex) {
           setState(_atn.ruleToStopState[p->ruleIndex]->stateNumber);
           getErrorHandler()->reportError(this, e);
           getContext()->exception = std::current_exception();
-          recover(e);
+          recover(e, getContext()->exception);
         }
 
         break;
@@ -141,6 +142,15 @@ void ParserInterpreter::enterRecursionRule(ParserRuleContext *localctx, size_t s
   Parser::enterRecursionRule(localctx, state, ruleIndex, precedence);
 }
 
+void ParserInterpreter::recoverFromError(const RecognitionException &e, std::exception_ptr exception) {
+  atn::ATNState *p = getATNState();
+  setState(_atn.ruleToStopState[p->ruleIndex]->stateNumber);
+  getErrorHandler()->reportError(this, e);
+  getContext()->exception = exception;
+  recover(e, exception);
+  _errorRecovered = true;
+}
+
 void ParserInterpreter::addDecisionOverride(int decision, int tokenIndex, int forcedAlt) {
   _overrideDecision = decision;
   _overrideDecisionInputIndex = tokenIndex;
@@ -163,6 +173,9 @@ void ParserInterpreter::visitState(atn::ATNState *p) {
   size_t predictedAlt = 1;
   if (is<DecisionState *>(p)) {
     predictedAlt = visitDecisionState(dynamic_cast<DecisionState *>(p));
+    if (takeRecoveredError()) {
+      return; // Continues at the rule stop state.
+    }
   }
 
   atn::Transition *transition = p->transitions[predictedAlt - 1];
@@ -188,6 +201,9 @@ void ParserInterpreter::visitState(atn::ATNState *p) {
     case atn::Transition::NOT_SET:
       if (!transition->matches(static_cast<int>(_input->LA(1)), Token::MIN_USER_TOKEN_TYPE, Lexer::MAX_CHAR_VALUE)) {
         recoverInline();
+        if (_errorRecovered) {
+          break;
+        }
       }
       matchWildcard();
       break;
@@ -213,6 +229,10 @@ void ParserInterpreter::visitState(atn::ATNState *p) {
     {
       atn::PredicateTransition *predicateTransition = static_cast<atn::PredicateTransition*>(transition);
       if (!sempred(_ctx, predicateTransition->ruleIndex, predicateTransition->predIndex)) {
+        if (isExceptionFreeRecovery()) {
+          recoverFromError(FailedPredicateException(this));
+          break;
+        }
         throw FailedPredicateException(this);
       }
     }
@@ -228,7 +248,12 @@ void ParserInterpreter::visitState(atn::ATNState *p) {
     case atn::Transition::PRECEDENCE:
     {
       if (!precpred(_ctx, static_cast<atn::PrecedencePredicateTransition*>(transition)->precedence)) {
-        throw FailedPredicateException(this, "precpred(_ctx, " + std::to_string(static_cast<atn::PrecedencePredicateTransition*>(transition)->precedence) +  ")");
+        FailedPredicateException e(this, "precpred(_ctx, " + std::to_string(static_cast<atn::PrecedencePredicateTransition*>(transition)->precedence) +  ")");
+        if (isExceptionFreeRecovery()) {
+          recoverFromError(e);
+          break;
+        }
+        throw e;
       }
     }
       break;
@@ -237,6 +262,9 @@ void ParserInterpreter::visitState(atn::ATNState *p) {
       throw UnsupportedOperationException("Unrecognized ATN transition type.");
   }
 
+  if (takeRecoveredError()) {
+    return;
+  }
   setState(transition->target->stateNumber);
 }
 
@@ -244,6 +272,9 @@ size_t ParserInterpreter::visitDecisionState(DecisionState *p) {
   size_t predictedAlt = 1;
   if (p->transitions.size() > 1) {
     getErrorHandler()->sync(this);
+    if (_errorRecovered) {
+      return predictedAlt;
+    }
     int decision = p->decision;
     if (decision == _overrideDecision && _input->index() == _overrideDecisionInputIndex && !_overrideDecisionReached) {
       predictedAlt = _overrideDecisionAlt;
@@ -276,27 +307,31 @@ void ParserInterpreter::visitRuleStopState(atn::ATNState *p) {
   setState(ruleTransition->followState->stateNumber);
 }
 
-void ParserInterpreter::recover(RecognitionException &e) {
+void ParserInterpreter::recover(const RecognitionException &e) {
+  recover(e, std::make_exception_ptr(e));
+}
+
+void ParserInterpreter::recover(const RecognitionException &e, std::exception_ptr exception) {
   size_t i = _input->index();
-  getErrorHandler()->recover(this, std::make_exception_ptr(e));
+  getErrorHandler()->recover(this, exception);
 
   if (_input->index() == i) {
     // no input consumed, better add an error node
-    if (is<InputMismatchException *>(&e)) {
-      InputMismatchException &ime = static_cast<InputMismatchException&>(e);
+    if (is<const InputMismatchException *>(&e)) {
+      const InputMismatchException &ime = static_cast<const InputMismatchException&>(e);
       Token *tok = e.getOffendingToken();
       size_t expectedTokenType = ime.getExpectedTokens().getMinElement(); // get any element
-      _errorToken = getTokenFactory()->create({ tok->getTokenSource(), tok->getTokenSource()->getInputStream() },
+      _errorTokens.push_back(getTokenFactory()->create({ tok->getTokenSource(), tok->getTokenSource()->getInputStream() },
         expectedTokenType, tok->getText(), Token::DEFAULT_CHANNEL, INVALID_INDEX, INVALID_INDEX, // invalid start/stop
-        tok->getLine(), tok->getCharPositionInLine());
-      _ctx->addChild(createErrorNode(_errorToken.get()));
+        tok->getLine(), tok->getCharPositionInLine()));
+      _ctx->addChild(createErrorNode(_errorTokens.back().get()));
     }
     else { // NoViableAlt
       Token *tok = e.getOffendingToken();
-      _errorToken = getTokenFactory()->create({ tok->getTokenSource(), tok->getTokenSource()->getInputStream() },
+      _errorTokens.push_back(getTokenFactory()->create({ tok->getTokenSource(), tok->getTokenSource()->getInputStream() },
         Token::INVALID_TYPE, tok->getText(), Token::DEFAULT_CHANNEL, INVALID_INDEX, INVALID_INDEX, // invalid start/stop
-        tok->getLine(), tok->getCharPositionInLine());
-      _ctx->addChild(createErrorNode(_errorToken.get()));
+        tok->getLine(), tok->getCharPositionInLine()));
+      _ctx->addChild(createErrorNode(_errorTokens.back().get()));
     }
   }
 }
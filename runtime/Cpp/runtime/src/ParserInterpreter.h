@@ -53,6 +53,11 @@ namespace antlr4 {
 
     virtual void enterRecursionRule(ParserRuleContext *localctx, size_t state, size_t ruleIndex, int precedence) override;
 
+    /// Handles the error like the catch clause in parse(), which also supports exception free recovery
+    /// (see Parser::setExceptionFreeRecovery()).
+    using Parser::recoverFromError;
+    virtual void recoverFromError(const RecognitionException &e, std::exception_ptr exception) override;
+
 
     /** Override this parser interpreters normal decision-making process
      *  at a particular decision and input token index. Instead of
@@ -168,12 +173,15 @@ namespace antlr4 {
      *  to recover, add an error node. Otherwise, nothing is seen in the parse
      *  tree.
      */
-    void recover(RecognitionException &e);
+    void recover(const RecognitionException &e);
     Token* recoverInline();
 
   private:
+    // The same, with the exception pointer already at hand (null if a recovered error isn't stored).
+    void recover(const RecognitionException &e, std::exception_ptr exception);
+
     const dfa::Vocabulary &_vocabulary;
-    std::unique_ptr<Token> _errorToken;
+    std::vector<std::unique_ptr<Token>> _errorTokens; // Referenced by the error nodes of the current tree.
   };
 
 } // namespace antlr4
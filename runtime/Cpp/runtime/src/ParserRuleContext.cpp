@@ -8,6 +8,7 @@
 #include "misc/Interval.h"
 #include "Parser.h"
 #include "Token.h"
+#include "CharStream.h"
 
 #include "support/CPPUtils.h"
 
@@ -35,10 +36,14 @@ void ParserRuleContext::copyFrom(ParserRuleContext *ctx) {
 
   this->start = ctx->start;
   this->stop = ctx->stop;
+  this->_ruleIndexOrTokenType = ctx->_ruleIndexOrTokenType;
 
   // copy any error nodes to alt label node
   if (!ctx->children.empty()) {
     for (auto child : ctx->children) {
+      if (child->getTreeType() != tree::ParseTreeType::ERROR) {
+        continue;
+      }
       auto errorNode = dynamic_cast<ErrorNode *>(child);
       if (errorNode != nullptr) {
         errorNode->setParent(this);
@@ -83,13 +88,9 @@ tree::TerminalNode* ParserRuleContext::getToken(size_t ttype, size_t i) {
 
   size_t j = 0; // what token with ttype have we found?
   for (auto o : children) {
-    if (is<tree::TerminalNode *>(o)) {
-      tree::TerminalNode *tnode = dynamic_cast<tree::TerminalNode *>(o);
-      Token *symbol = tnode->getSymbol();
-      if (symbol->getType() == ttype) {
-        if (j++ == i) {
-          return tnode;
-        }
+    if (o->getTreeType() != tree::ParseTreeType::RULE && o->getRuleIndexOrTokenType() == ttype) { // Terminal and error nodes.
+      if (j++ == i) {
+        return static_cast<tree::TerminalNode *>(o);
       }
     }
   }
@@ -100,12 +101,8 @@ tree::TerminalNode* ParserRuleContext::getToken(size_t ttype, size_t i) {
 std::vector<tree::TerminalNode *> ParserRuleContext::getTokens(size_t ttype) {
   std::vector<tree::TerminalNode *> tokens;
   for (auto &o : children) {
-    if (is<tree::TerminalNode *>(o)) {
-      tree::TerminalNode *tnode = dynamic_cast<tree::TerminalNode *>(o);
-      Token *symbol = tnode->getSymbol();
-      if (symbol->getType() == ttype) {
-        tokens.push_back(tnode);
-      }
+    if (o->getTreeType() != tree::ParseTreeType::RULE && o->getRuleIndexOrTokenType() == ttype) { // Terminal and error nodes.
+      tokens.push_back(static_cast<tree::TerminalNode *>(o));
     }
   }
 
@@ -123,6 +120,20 @@ misc::Interval ParserRuleContext::getSourceInterval() {
   return misc::Interval(start->getTokenIndex(), stop->getTokenIndex());
 }
 
+std::string ParserRuleContext::getSourceText() {
+  if (start == nullptr || stop == nullptr || stop->getTokenIndex() < start->getTokenIndex()) {
+    return "";
+  }
+
+  CharStream *input = start->getInputStream();
+  if (input == nullptr || input != stop->getInputStream() || start->getStartIndex() == INVALID_INDEX ||
+      stop->getStartIndex() == INVALID_INDEX) {
+    return getText();
+  }
+
+  return input->getText(misc::Interval(start->getStartIndex(), stop->getStopIndex()));
+}
+
 Token* ParserRuleContext::getStart() {
   return start;
 }
@@ -102,6 +102,9 @@ namespace antlr4 {
 
       size_t j = 0; // what element have we found with ctxType?
       for (auto &child : children) {
+        if (child->getTreeType() != tree::ParseTreeType::RULE) {
+          continue;
+        }
         if (antlrcpp::is<T *>(child)) {
           if (j++ == i) {
             return dynamic_cast<T *>(child);
@@ -111,10 +114,29 @@ namespace antlr4 {
       return nullptr;
     }
 
+    /// Same as getRuleContext<T>(i), but selects the children by their rule index instead of a dynamic_cast.
+    /// All contexts with the given rule index must be of type T (or derived from it), which is always the case
+    /// for the context classes of a generated parser.
+    template<typename T>
+    T* getRuleContext(size_t ruleIndex, size_t i) {
+      size_t j = 0;
+      for (auto &child : children) {
+        if (child->getTreeType() == tree::ParseTreeType::RULE && child->getRuleIndexOrTokenType() == ruleIndex) {
+          if (j++ == i) {
+            return static_cast<T *>(child);
+          }
+        }
+      }
+      return nullptr;
+    }
+
     template<typename T>
     std::vector<T *> getRuleContexts() {
       std::vector<T *> contexts;
       for (auto child : children) {
+        if (child->getTreeType() != tree::ParseTreeType::RULE) {
+          continue;
+        }
         if (antlrcpp::is<T *>(child)) {
           contexts.push_back(dynamic_cast<T *>(child));
         }
@@ -123,6 +145,19 @@ namespace antlr4 {
       return contexts;
     }
 
+    /// Same as getRuleContexts<T>(), but selects the children by their rule index (see getRuleContext()).
+    template<typename T>
+    std::vector<T *> getRuleContexts(size_t ruleIndex) {
+      std::vector<T *> contexts;
+      for (auto child : children) {
+        if (child->getTreeType() == tree::ParseTreeType::RULE && child->getRuleIndexOrTokenType() == ruleIndex) {
+          contexts.push_back(static_cast<T *>(child));
+        }
+      }
+
+      return contexts;
+    }
+
     virtual misc::Interval getSourceInterval() override;
 
     /**
@@ -139,6 +174,13 @@ namespace antlr4 {
      */
     virtual Token *getStop();
 
+    /// Returns the full source text of this context, from the start of the first to the end of the last
+    /// token, taken directly from the char stream. Unlike getText(), which joins the on-channel tokens,
+    /// this includes hidden channel tokens and skipped input (whitespace, comments) between them.
+    /// Falls back to getText() if the tokens don't refer to a char stream (or were conjured up during
+    /// error recovery).
+    virtual std::string getSourceText();
+
     /// <summary>
     /// Used for rule context info debugging during parse-time, not so much for ATN debugging </summary>
     virtual std::string toInfoString(Parser *recognizer);
@@ -15,11 +15,11 @@
 using namespace antlr4;
 using namespace antlr4::atn;
 
-RuleContext::RuleContext() {
+RuleContext::RuleContext() : ParseTree(tree::ParseTreeType::RULE) {
   InitializeInstanceFields();
 }
 
-RuleContext::RuleContext(RuleContext *parent_, size_t invokingState_) {
+RuleContext::RuleContext(RuleContext *parent_, size_t invokingState_) : ParseTree(tree::ParseTreeType::RULE) {
   InitializeInstanceFields();
   this->parent = parent_;
   this->invokingState = invokingState_;
@@ -46,18 +46,35 @@ misc::Interval RuleContext::getSourceInterval() {
 }
 
 std::string RuleContext::getText() {
+  std::string result;
   if (children.empty()) {
-    return "";
+    return result;
   }
 
-  std::stringstream ss;
-  for (size_t i = 0; i < children.size(); i++) {
-    ParseTree *tree = children[i];
-    if (tree != nullptr)
-      ss << tree->getText();
+  // Depth first walk over the subtree, appending the text of each leaf in order.
+  std::vector<std::pair<ParseTree *, size_t>> stack;
+  stack.push_back({ this, 0 });
+  while (!stack.empty()) {
+    ParseTree *node = stack.back().first;
+    size_t index = stack.back().second;
+    if (index == node->children.size()) {
+      stack.pop_back();
+      continue;
+    }
+    ++stack.back().second;
+
+    ParseTree *child = node->children[index];
+    if (child == nullptr) {
+      continue;
+    }
+    if (child->getTreeType() == tree::ParseTreeType::RULE) {
+      stack.push_back({ child, 0 });
+    } else {
+      result += child->getText();
+    }
   }
 
-  return ss.str();
+  return result;
 }
 
 size_t RuleContext::getRuleIndex() const {
@@ -78,6 +78,9 @@ namespace antlr4 {
 
     virtual misc::Interval getSourceInterval() override;
 
+    /// Returns the concatenated text of all leaves (tokens and error nodes) in this subtree, i.e. the text
+    /// of the on-channel tokens. The text is collected in a single pass, without building the text of
+    /// each nested context separately. See ParserRuleContext::getSourceText() for the full source text.
     virtual std::string getText() override;
 
     virtual size_t getRuleIndex() const;
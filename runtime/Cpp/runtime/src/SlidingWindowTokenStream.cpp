@@ -0,0 +1,262 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "Exceptions.h"
+#include "RuleContext.h"
+#include "TokenSource.h"
+#include "WritableToken.h"
+#include "misc/Interval.h"
+#include "support/CPPUtils.h"
+
+#include "SlidingWindowTokenStream.h"
+
+using namespace antlr4;
+using namespace antlrcpp;
+
+SlidingWindowTokenStream::SlidingWindowTokenStream(TokenSource *tokenSource)
+  : SlidingWindowTokenStream(tokenSource, Token::DEFAULT_CHANNEL) {
+}
+
+SlidingWindowTokenStream::SlidingWindowTokenStream(TokenSource *tokenSource, size_t channel, size_t segmentSize)
+  : _tokenSource(tokenSource), _channel(channel), _segmentSize(segmentSize), _windowStart(0), _p(0), _position(0),
+    _fetchedEOF(false), _retainedIndex(INVALID_INDEX) {
+  if (_segmentSize == 0) {
+    throw IllegalArgumentException("segment size must be > 0");
+  }
+
+  // Prime the pump with the first on-channel token.
+  syncOnChannel(0);
+  _p = _onChannelTokens.front();
+}
+
+SlidingWindowTokenStream::~SlidingWindowTokenStream() {
+}
+
+Token* SlidingWindowTokenStream::get(size_t i) const {
+  if (i < _windowStart || i >= _windowStart + _tokens.size()) {
+    throw IndexOutOfBoundsException(std::string("get(") + std::to_string(i) + std::string(") outside window: ")
+      + std::to_string(_windowStart) + std::string("..") + std::to_string(_windowStart + _tokens.size()));
+  }
+  return tokenAt(i);
+}
+
+Token* SlidingWindowTokenStream::LT(ssize_t k) {
+  if (k == 0) {
+    return nullptr;
+  }
+
+  if (k < 0) {
+    size_t n = static_cast<size_t>(-k);
+    if (n > _position) {
+      return nullptr;
+    }
+    return tokenAt(_onChannelTokens[_position - n]);
+  }
+
+  size_t target = _position + static_cast<size_t>(k) - 1;
+  if (!syncOnChannel(target)) {
+    return tokenAt(_onChannelTokens.back()); // EOF
+  }
+  return tokenAt(_onChannelTokens[target]);
+}
+
+size_t SlidingWindowTokenStream::LA(ssize_t i) {
+  return LT(i)->getType();
+}
+
+TokenSource* SlidingWindowTokenStream::getTokenSource() const {
+  return _tokenSource;
+}
+
+std::string SlidingWindowTokenStream::getText(const misc::Interval &interval) {
+  size_t start = interval.a;
+  size_t stop = interval.b;
+  if (start == INVALID_INDEX || stop == INVALID_INDEX || _tokens.empty()) {
+    return "";
+  }
+
+  if (start < _windowStart) {
+    throw UnsupportedOperationException(std::string("interval ") + interval.toString() +
+      " starts before the token window: " + std::to_string(_windowStart) + ".." +
+      std::to_string(_windowStart + _tokens.size() - 1));
+  }
+
+  while (stop >= _windowStart + _tokens.size() && fetch(1) > 0)
+    ;
+  stop = std::min(stop, _windowStart + _tokens.size() - 1);
+
+  std::stringstream ss;
+  for (size_t i = start; i <= stop; ++i) {
+    Token *t = tokenAt(i);
+    if (t->getType() == Token::EOF) {
+      break;
+    }
+    ss << t->getText();
+  }
+  return ss.str();
+}
+
+std::string SlidingWindowTokenStream::getText() {
+  if (_tokens.empty()) {
+    return "";
+  }
+  return getText(misc::Interval(_windowStart, _windowStart + _tokens.size() - 1));
+}
+
+std::string SlidingWindowTokenStream::getText(RuleContext *ctx) {
+  return getText(ctx->getSourceInterval());
+}
+
+std::string SlidingWindowTokenStream::getText(Token *start, Token *stop) {
+  if (start != nullptr && stop != nullptr) {
+    return getText(misc::Interval(start->getTokenIndex(), stop->getTokenIndex()));
+  }
+
+  return "";
+}
+
+void SlidingWindowTokenStream::consume() {
+  if (LA(1) == Token::EOF) {
+    throw IllegalStateException("cannot consume EOF");
+  }
+
+  // There is always another on-channel token after a non-EOF token, at the latest EOF itself.
+  syncOnChannel(++_position);
+  _p = _onChannelTokens[_position];
+  discardSegments();
+}
+
+ssize_t SlidingWindowTokenStream::mark() {
+  // Seeking back to the mark must restore LT(-1) as well.
+  _markers.push_back(_position > 0 ? _onChannelTokens[_position - 1] : _p);
+  return -static_cast<ssize_t>(_markers.size());
+}
+
+void SlidingWindowTokenStream::release(ssize_t marker) {
+  if (_markers.empty() || marker != -static_cast<ssize_t>(_markers.size())) {
+    throw IllegalStateException("release() called with an invalid marker.");
+  }
+
+  _markers.pop_back();
+  discardSegments();
+}
+
+size_t SlidingWindowTokenStream::index() {
+  return _p;
+}
+
+void SlidingWindowTokenStream::seek(size_t index) {
+  if (index < _windowStart) {
+    throw IllegalArgumentException("cannot seek to index " + std::to_string(index) +
+      " before the token window starting at " + std::to_string(_windowStart));
+  }
+
+  // Move to the first on-channel token at or after index, or EOF.
+  while (index >= _windowStart + _tokens.size() && fetch(1) > 0)
+    ;
+  auto iterator = std::lower_bound(_onChannelTokens.begin(), _onChannelTokens.end(), index);
+  size_t position = static_cast<size_t>(iterator - _onChannelTokens.begin());
+  if (!syncOnChannel(position)) {
+    position = _onChannelTokens.size() - 1;
+  }
+
+  _position = position;
+  _p = _onChannelTokens[position];
+  discardSegments();
+}
+
+size_t SlidingWindowTokenStream::size() {
+  if (!_fetchedEOF) {
+    throw UnsupportedOperationException("the size of a sliding window token stream is unknown before EOF was fetched");
+  }
+  return _windowStart + _tokens.size();
+}
+
+std::string SlidingWindowTokenStream::getSourceName() const {
+  return _tokenSource->getSourceName();
+}
+
+void SlidingWindowTokenStream::setRetainedIndex(size_t index) {
+  _retainedIndex = index;
+  discardSegments();
+}
+
+size_t SlidingWindowTokenStream::getRetainedIndex() const {
+  return _retainedIndex;
+}
+
+size_t SlidingWindowTokenStream::getWindowStart() const {
+  return _windowStart;
+}
+
+size_t SlidingWindowTokenStream::getWindowSize() const {
+  return _tokens.size();
+}
+
+size_t SlidingWindowTokenStream::fetch(size_t n) {
+  if (_fetchedEOF) {
+    return 0;
+  }
+
+  size_t i = 0;
+  while (i < n) {
+    std::unique_ptr<Token> t(_tokenSource->nextToken());
+    size_t index = _windowStart + _tokens.size();
+    if (is<WritableToken *>(t.get())) {
+      static_cast<WritableToken *>(t.get())->setTokenIndex(index);
+    }
+
+    bool isEOF = t->getType() == Token::EOF;
+    if (isEOF || t->getChannel() == _channel) {
+      _onChannelTokens.push_back(index);
+    }
+    _tokens.push_back(std::move(t));
+    ++i;
+
+    if (isEOF) {
+      _fetchedEOF = true;
+      break;
+    }
+  }
+
+  return i;
+}
+
+bool SlidingWindowTokenStream::syncOnChannel(size_t position) {
+  while (position >= _onChannelTokens.size()) {
+    if (fetch(1) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SlidingWindowTokenStream::discardSegments() {
+  // Everything from the LT(-1) token on must stay.
+  size_t keep = _position > 0 ? _onChannelTokens[_position - 1] : _p;
+  for (size_t marker : _markers) {
+    keep = std::min(keep, marker);
+  }
+  keep = std::min(keep, _retainedIndex);
+
+  if (keep < _windowStart + _segmentSize) {
+    return;
+  }
+
+  size_t count = (keep - _windowStart) / _segmentSize * _segmentSize;
+  _tokens.erase(_tokens.begin(), _tokens.begin() + static_cast<ssize_t>(count));
+  _windowStart += count;
+
+  size_t dropped = 0;
+  while (_onChannelTokens[dropped] < _windowStart) {
+    ++dropped;
+  }
+  _onChannelTokens.erase(_onChannelTokens.begin(), _onChannelTokens.begin() + static_cast<ssize_t>(dropped));
+  _position -= dropped;
+}
+
+Token* SlidingWindowTokenStream::tokenAt(size_t i) const {
+  return _tokens[i - _windowStart].get();
+}
@@ -0,0 +1,121 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "TokenStream.h"
+
+namespace antlr4 {
+
+  /// A token stream which filters for a channel like CommonTokenStream, but keeps only a window of the
+  /// fetched tokens in memory. Tokens are discarded in segments of a fixed size, once they are behind
+  /// all of:
+  ///
+  ///   - the earliest live mark (prediction marks the stream and seeks back),
+  ///   - the retained index (see setRetainedIndex()),
+  ///   - the LT(-1) token (the parser uses it as stop token of a rule).
+  ///
+  /// Together with a parser which does not build a parse tree (setBuildParseTree(false)), the memory
+  /// used for tokens stays bounded, regardless of the input size.
+  ///
+  /// Note: rule contexts which span more than the window still point to their (discarded) start token.
+  /// Don't access start/stop tokens of such contexts (e.g. in actions or parse listeners), or keep
+  /// them alive with setRetainedIndex().
+  class ANTLR4CPP_PUBLIC SlidingWindowTokenStream : public TokenStream {
+  public:
+    static const size_t DEFAULT_SEGMENT_SIZE = 4096;
+
+    SlidingWindowTokenStream(TokenSource *tokenSource);
+    SlidingWindowTokenStream(TokenSource *tokenSource, size_t channel, size_t segmentSize = DEFAULT_SEGMENT_SIZE);
+    SlidingWindowTokenStream(const SlidingWindowTokenStream& other) = delete;
+    virtual ~SlidingWindowTokenStream();
+
+    SlidingWindowTokenStream& operator = (const SlidingWindowTokenStream& other) = delete;
+
+    /// Throws IndexOutOfBoundsException if the token is not in the window.
+    virtual Token* get(size_t i) const override;
+    virtual Token* LT(ssize_t k) override;
+    virtual size_t LA(ssize_t i) override;
+
+    virtual TokenSource* getTokenSource() const override;
+
+    /// Throws UnsupportedOperationException if the interval starts before the window.
+    virtual std::string getText(const misc::Interval &interval) override;
+
+    /// Returns the text of all tokens in the window.
+    virtual std::string getText() override;
+    virtual std::string getText(RuleContext *ctx) override;
+    virtual std::string getText(Token *start, Token *stop) override;
+
+    virtual void consume() override;
+
+    /// Markers must be released in reverse order of creation.
+    virtual ssize_t mark() override;
+    virtual void release(ssize_t marker) override;
+
+    virtual size_t index() override;
+
+    /// Throws IllegalArgumentException if the index is before the window.
+    virtual void seek(size_t index) override;
+
+    /// Throws UnsupportedOperationException if the EOF token has not been fetched yet.
+    virtual size_t size() override;
+    virtual std::string getSourceName() const override;
+
+    /// Tokens at or after the given index are never discarded. Set it to the index of the oldest token
+    /// referenced by a parse tree (or anything else) still in use, and move it forward (or reset it to
+    /// INVALID_INDEX, the default) when that is no longer needed.
+    virtual void setRetainedIndex(size_t index);
+    virtual size_t getRetainedIndex() const;
+
+    /// The absolute index of the first token still in memory.
+    virtual size_t getWindowStart() const;
+
+    /// The number of tokens in memory.
+    virtual size_t getWindowSize() const;
+
+  protected:
+    TokenSource *_tokenSource;
+
+    /// Specifies the channel to use for filtering tokens (see CommonTokenStream).
+    size_t _channel;
+
+    /// The number of tokens discarded at once.
+    size_t _segmentSize;
+
+    /// The tokens in the window, _tokens[0] has the (absolute) index _windowStart.
+    std::deque<std::unique_ptr<Token>> _tokens;
+    size_t _windowStart;
+
+    /// Absolute indices of all on-channel tokens (and EOF) in the window, in ascending order.
+    std::deque<size_t> _onChannelTokens;
+
+    /// The absolute index of the current token (which is always on channel).
+    size_t _p;
+
+    /// The position of _p in _onChannelTokens.
+    size_t _position;
+
+    bool _fetchedEOF;
+
+    /// For each live marker the LT(-1) token index at the time it was created (or the current index, if
+    /// there was no previous token).
+    std::vector<size_t> _markers;
+
+    size_t _retainedIndex;
+
+    /// Adds up to {@code n} tokens to the window and returns the actual number of tokens added.
+    virtual size_t fetch(size_t n);
+
+    /// Makes sure _onChannelTokens has an entry at {@code position}. Returns false if EOF comes first.
+    bool syncOnChannel(size_t position);
+
+    /// Drops all complete segments which are no longer needed from the window.
+    virtual void discardSegments();
+
+    Token* tokenAt(size_t i) const;
+  };
+
+} // namespace antlr4
@@ -41,7 +41,7 @@ std::string TokenStreamRewriter::RewriteOperation::toString() {
   std::string opName = "TokenStreamRewriter";
   size_t dollarIndex = opName.find('$');
   opName = opName.substr(dollarIndex + 1, opName.length() - (dollarIndex + 1));
-  return "<" + opName + "@" + outerInstance->tokens->get(dollarIndex)->getText() + ":\"" + text + "\">";
+  return "<" + opName + "@" + outerInstance->tokens->get(index)->getText() + ":\"" + text + "\">";
 }
 
 void TokenStreamRewriter::RewriteOperation::InitializeInstanceFields() {
@@ -257,6 +257,26 @@ std::string TokenStreamRewriter::getText(const Interval &interval) {
 }
 
 std::string TokenStreamRewriter::getText(const std::string &programName, const Interval &interval) {
+  std::vector<TokenStreamRewriter::RewriteOperation*> &rewrites = _programs[programName];
+  if (rewrites.empty()) {
+    return tokens->getText(interval); // no instructions to execute
+  }
+
+  std::string buf;
+  getText(programName, interval, [&buf](const std::string &text) {
+    buf.append(text);
+  });
+  return buf;
+}
+
+void TokenStreamRewriter::getText(const std::string &programName, const Interval &interval, std::ostream &out) {
+  getText(programName, interval, [&out](const std::string &text) {
+    out << text;
+  });
+}
+
+void TokenStreamRewriter::getText(const std::string &programName, const Interval &interval,
+  const std::function<void (const std::string &)> &sink) {
   std::vector<TokenStreamRewriter::RewriteOperation*> &rewrites = _programs[programName];
   size_t start = interval.a;
   size_t stop = interval.b;
@@ -269,29 +289,32 @@ std::string TokenStreamRewriter::getText(const std::string &programName, const I
     start = 0;
   }
 
-  if (rewrites.empty() || rewrites.empty()) {
-    return tokens->getText(interval); // no instructions to execute
-  }
-  std::string buf;
-
   // First, optimize instruction stream
-  std::unordered_map<size_t, TokenStreamRewriter::RewriteOperation*> indexToOp = reduceToSingleOperationPerIndex(rewrites);
+  std::map<size_t, TokenStreamRewriter::RewriteOperation*> indexToOp = reduceToSingleOperationPerIndex(rewrites);
 
-  // Walk buffer, executing instructions and emitting tokens
+  // Walk buffer, executing instructions and emitting tokens. The operations are ordered by token index,
+  // so we only need to look at the next one.
+  std::string buf;
+  auto next = indexToOp.lower_bound(start);
   size_t i = start;
   while (i <= stop && i < tokens->size()) {
-    RewriteOperation *op = indexToOp[i];
-    indexToOp.erase(i); // remove so any left have index size-1
-    Token *t = tokens->get(i);
-    if (op == nullptr) {
+    // Skip operations within the range of a replace.
+    while (next != indexToOp.end() && next->first < i) {
+      ++next;
+    }
+
+    if (next == indexToOp.end() || next->first != i) {
       // no operation at that index, just dump token
+      Token *t = tokens->get(i);
       if (t->getType() != Token::EOF) {
-        buf.append(t->getText());
+        sink(t->getText());
       }
       i++; // move to next token
-    }
-    else {
-      i = op->execute(&buf); // execute operation and skip
+    } else {
+      buf.clear();
+      i = next->second->execute(&buf); // execute operation and skip
+      sink(buf);
+      next = indexToOp.erase(next); // remove so any left have index size-1
     }
   }
 
@@ -301,49 +324,73 @@ std::string TokenStreamRewriter::getText(const std::string &programName, const I
   if (stop == tokens->size() - 1) {
     // Scan any remaining operations after last token
     // should be included (they will be inserts).
-    for (auto op : indexToOp) {
-      if (op.second->index >= tokens->size() - 1) {
-        buf.append(op.second->text);
-      }
+    for (auto iterator = indexToOp.lower_bound(tokens->size() - 1); iterator != indexToOp.end(); ++iterator) {
+      sink(iterator->second->text);
     }
   }
-  return buf;
 }
 
-std::unordered_map<size_t, TokenStreamRewriter::RewriteOperation*> TokenStreamRewriter::reduceToSingleOperationPerIndex(
+std::map<size_t, TokenStreamRewriter::RewriteOperation*> TokenStreamRewriter::reduceToSingleOperationPerIndex(
   std::vector<TokenStreamRewriter::RewriteOperation*> &rewrites) {
 
+  auto kill = [&rewrites](RewriteOperation *op) {
+    rewrites[op->instructionIndex] = nullptr;
+    delete op;
+  };
 
   // WALK REPLACES
+  // Prior inserts which are still alive, by token index (in instruction order per index) and prior
+  // replaces by start index. The replaces in this map never overlap.
+  std::map<size_t, std::vector<InsertBeforeOp *>> inserts;
+  std::map<size_t, ReplaceOp *> replaces;
   for (size_t i = 0; i < rewrites.size(); ++i) {
     TokenStreamRewriter::RewriteOperation *op = rewrites[i];
+    InsertBeforeOp *iop = dynamic_cast<InsertBeforeOp *>(op);
+    if (iop != nullptr) {
+      inserts[iop->index].push_back(iop);
+      continue;
+    }
+
     ReplaceOp *rop = dynamic_cast<ReplaceOp *>(op);
     if (rop == nullptr)
       continue;
 
     // Wipe prior inserts within range
-    std::vector<InsertBeforeOp *> inserts = getKindOfOps<InsertBeforeOp>(rewrites, i);
-    for (auto iop : inserts) {
-      if (iop->index == rop->index) {
-        // E.g., insert before 2, delete 2..2; update replace
-        // text to include insert before, kill insert
-        delete rewrites[iop->instructionIndex];
-        rewrites[iop->instructionIndex] = nullptr;
-        rop->text = iop->text + (!rop->text.empty() ? rop->text : "");
-      }
-      else if (iop->index > rop->index && iop->index <= rop->lastIndex) {
-        // delete insert as it's a no-op.
-        delete rewrites[iop->instructionIndex];
-        rewrites[iop->instructionIndex] = nullptr;
+    auto first = inserts.lower_bound(rop->index);
+    auto last = inserts.upper_bound(rop->lastIndex);
+    for (auto iterator = first; iterator != last; ++iterator) {
+      for (auto prevIop : iterator->second) {
+        if (prevIop->index == rop->index) {
+          // E.g., insert before 2, delete 2..2; update replace
+          // text to include insert before, kill insert
+          rop->text = prevIop->text + rop->text;
+        }
+        // else delete insert as it's a no-op.
+        kill(prevIop);
       }
     }
-    // Drop any prior replaces contained within
-    std::vector<ReplaceOp*> prevReplaces = getKindOfOps<ReplaceOp>(rewrites, i);
+    inserts.erase(first, last);
+
+    // Drop any prior replaces contained within. Only overlapping replaces need to be looked at and since
+    // they are disjoint, these form a contiguous range in the map.
+    auto begin = replaces.upper_bound(rop->index);
+    if (begin != replaces.begin() && std::prev(begin)->second->lastIndex >= rop->index) {
+      --begin;
+    }
+    auto end = replaces.upper_bound(rop->lastIndex);
+    std::vector<ReplaceOp *> prevReplaces;
+    for (auto iterator = begin; iterator != end; ++iterator) {
+      prevReplaces.push_back(iterator->second);
+    }
+    replaces.erase(begin, end);
+
+    std::sort(prevReplaces.begin(), prevReplaces.end(), [](ReplaceOp *lhs, ReplaceOp *rhs) {
+      return lhs->instructionIndex < rhs->instructionIndex;
+    });
     for (auto prevRop : prevReplaces) {
       if (prevRop->index >= rop->index && prevRop->lastIndex <= rop->lastIndex) {
         // delete replace as it's a no-op.
-        delete rewrites[prevRop->instructionIndex];
-        rewrites[prevRop->instructionIndex] = nullptr;
+        kill(prevRop);
         continue;
       }
       // throw exception unless disjoint or identical
@@ -352,54 +399,66 @@ std::unordered_map<size_t, TokenStreamRewriter::RewriteOperation*> TokenStreamRe
       // Delete special case of replace (text==null):
       // D.i-j.u D.x-y.v    | boundaries overlap    combine to max(min)..max(right)
       if (prevRop->text.empty() && rop->text.empty() && !disjoint) {
-        delete rewrites[prevRop->instructionIndex];
-        rewrites[prevRop->instructionIndex] = nullptr; // kill first delete
         rop->index = std::min(prevRop->index, rop->index);
         rop->lastIndex = std::max(prevRop->lastIndex, rop->lastIndex);
-        std::cout << "new rop " << rop << std::endl;
+        kill(prevRop); // kill first delete
       }
       else if (!disjoint && !same) {
         throw IllegalArgumentException("replace op boundaries of " + rop->toString() +
                                        " overlap with previous " + prevRop->toString());
       }
+      else {
+        replaces[prevRop->index] = prevRop;
+      }
     }
+    replaces[rop->index] = rop;
   }
 
   // WALK INSERTS
+  // Now the prior inserts per index have been combined into one and the replaces have their final range.
+  std::map<size_t, InsertBeforeOp *> insertAt;
+  replaces.clear();
   for (size_t i = 0; i < rewrites.size(); i++) {
+    ReplaceOp *rop = dynamic_cast<ReplaceOp *>(rewrites[i]);
+    if (rop != nullptr) {
+      replaces[rop->index] = rop;
+      continue;
+    }
+
     InsertBeforeOp *iop = dynamic_cast<InsertBeforeOp *>(rewrites[i]);
     if (iop == nullptr)
       continue;
 
     // combine current insert with prior if any at same index
-
-    std::vector<InsertBeforeOp *> prevInserts = getKindOfOps<InsertBeforeOp>(rewrites, i);
-    for (auto prevIop : prevInserts) {
-      if (prevIop->index == iop->index) { // combine objects
-                                          // convert to strings...we're in process of toString'ing
-                                          // whole token buffer so no lazy eval issue with any templates
-        iop->text = catOpText(&iop->text, &prevIop->text);
-        // delete redundant prior insert
-        delete rewrites[prevIop->instructionIndex];
-        rewrites[prevIop->instructionIndex] = nullptr;
-      }
+    auto prevIop = insertAt.find(iop->index);
+    if (prevIop != insertAt.end()) {
+      // convert to strings...we're in process of toString'ing
+      // whole token buffer so no lazy eval issue with any templates
+      iop->text = catOpText(&iop->text, &prevIop->second->text);
+      // delete redundant prior insert
+      kill(prevIop->second);
+      prevIop->second = iop;
+    } else {
+      insertAt[iop->index] = iop;
     }
+
     // look for replaces where iop.index is in range; error
-    std::vector<ReplaceOp*> prevReplaces = getKindOfOps<ReplaceOp>(rewrites, i);
-    for (auto rop : prevReplaces) {
-      if (iop->index == rop->index) {
-        rop->text = catOpText(&iop->text, &rop->text);
-        delete rewrites[i];
-        rewrites[i] = nullptr; // delete current insert
-        continue;
-      }
-      if (iop->index >= rop->index && iop->index <= rop->lastIndex) {
-        throw IllegalArgumentException("insert op " + iop->toString() + " within boundaries of previous " + rop->toString());
-      }
+    auto iterator = replaces.upper_bound(iop->index);
+    if (iterator == replaces.begin())
+      continue;
+    rop = std::prev(iterator)->second;
+    if (iop->index == rop->index) {
+      rop->text = catOpText(&iop->text, &rop->text);
+      insertAt.erase(iop->index);
+      kill(iop); // delete current insert
+      continue;
+    }
+    if (iop->index <= rop->lastIndex) {
+      throw IllegalArgumentException("insert op " + iop->toString() + " within boundaries of previous " + rop->toString());
     }
   }
 
-  std::unordered_map<size_t, TokenStreamRewriter::RewriteOperation*> m;
+  std::map<size_t, TokenStreamRewriter::RewriteOperation*> m;
   for (TokenStreamRewriter::RewriteOperation *op : rewrites) {
     if (op == nullptr) { // ignore deleted ops
       continue;
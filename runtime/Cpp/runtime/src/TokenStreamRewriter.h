@@ -152,6 +152,14 @@ namespace antlr4 {
 
     virtual std::string getText(const std::string &programName, const misc::Interval &interval);
 
+    /// Like getText(programName, interval), but passes the text piece by piece (token texts and operation
+    /// texts) to the given sink, instead of building the entire result string.
+    virtual void getText(const std::string &programName, const misc::Interval &interval,
+                         const std::function<void (const std::string &)> &sink);
+
+    /// Writes the text of the given interval with all alterations of the program to the stream.
+    virtual void getText(const std::string &programName, const misc::Interval &interval, std::ostream &out);
+
   protected:
     class RewriteOperation {
     public:
@@ -266,8 +274,12 @@ namespace antlr4 {
     ///  body, I think the stuff before the '{' you added should disappear too.
     ///
     ///  Return a map from token index to operation.
+    ///
+    ///  Instead of comparing each operation with all earlier ones, the earlier operations which are still alive
+    ///  are kept ordered by token index, so that the operations in range of a replace are found by a range
+    ///  lookup. This takes O(n log n) for n operations.
     /// </summary>
-    virtual std::unordered_map<size_t, RewriteOperation*> reduceToSingleOperationPerIndex(std::vector<RewriteOperation*> &rewrites);
+    virtual std::map<size_t, RewriteOperation*> reduceToSingleOperationPerIndex(std::vector<RewriteOperation*> &rewrites);
 
     virtual std::string catOpText(std::string *a, std::string *b);
 
@@ -0,0 +1,247 @@
+﻿/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "Exceptions.h"
+#include "misc/Interval.h"
+
+#include "UTF8CharStream.h"
+
+using namespace antlr4;
+
+using misc::Interval;
+
+namespace {
+
+  // Length of a sequence, given its (valid) lead byte.
+  inline size_t sequenceLength(unsigned char lead) {
+    if (lead < 0x80)
+      return 1;
+    if (lead < 0xE0)
+      return 2;
+    if (lead < 0xF0)
+      return 3;
+    return 4;
+  }
+
+  // Returns the length of the sequence starting at p or 0 if it is not well formed (overlong, surrogate,
+  // out of range or truncated).
+  size_t validSequenceLength(const unsigned char *p, size_t available) {
+    unsigned char c = p[0];
+    if (c < 0x80)
+      return 1;
+    if (c < 0xC2)
+      return 0;
+
+    if (c < 0xE0)
+      return (available >= 2 && (p[1] & 0xC0) == 0x80) ? 2 : 0;
+
+    if (c < 0xF0) {
+      if (available < 3 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80)
+        return 0;
+      if ((c == 0xE0 && p[1] < 0xA0) || (c == 0xED && p[1] > 0x9F))
+        return 0;
+      return 3;
+    }
+
+    if (c < 0xF5) {
+      if (available < 4 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80)
+        return 0;
+      if ((c == 0xF0 && p[1] < 0x90) || (c == 0xF4 && p[1] > 0x8F))
+        return 0;
+      return 4;
+    }
+
+    return 0;
+  }
+
+  inline size_t decode(const unsigned char *p) {
+    size_t c = p[0];
+    if (c < 0x80)
+      return c;
+    if (c < 0xE0)
+      return ((c & 0x1F) << 6) | (p[1] & 0x3F);
+    if (c < 0xF0)
+      return ((c & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+    return ((c & 0x07) << 18) | ((p[1] & 0x3F) << 12) | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+  }
+
+}
+
+UTF8CharStream::UTF8CharStream() : _data(nullptr), _length(0), _size(0), _p(0), _index(0) {
+  _checkpoints.push_back(0);
+}
+
+UTF8CharStream::UTF8CharStream(const char *data, size_t length) : UTF8CharStream() {
+  load(data, length);
+}
+
+UTF8CharStream::~UTF8CharStream() {
+}
+
+void UTF8CharStream::load(const char *data, size_t length) {
+  // Remove the UTF-8 BOM if present.
+  if (length >= 3 && memcmp(data, "\xef\xbb\xbf", 3) == 0) {
+    data += 3;
+    length -= 3;
+  }
+
+  _data = reinterpret_cast<const unsigned char *>(data);
+  _length = length;
+  _p = 0;
+  _index = 0;
+  _checkpoints.clear();
+
+  // Validate the input, count the code points and record the checkpoints in one pass.
+  size_t offset = 0;
+  size_t count = 0;
+  while (offset < length) {
+    if (count % CHECKPOINT_INTERVAL == 0) {
+      _checkpoints.push_back(offset);
+    }
+
+    size_t todo = CHECKPOINT_INTERVAL - count % CHECKPOINT_INTERVAL;
+    while (todo > 0 && offset < length) {
+      // Skip pure ASCII 8 bytes at a time.
+      if (todo >= 8 && length - offset >= 8) {
+        uint64_t block;
+        memcpy(&block, _data + offset, 8);
+        if ((block & 0x8080808080808080ULL) == 0) {
+          offset += 8;
+          count += 8;
+          todo -= 8;
+          continue;
+        }
+      }
+
+      size_t n = validSequenceLength(_data + offset, length - offset);
+      if (n == 0) {
+        throw IllegalArgumentException("invalid UTF-8 sequence at byte offset " + std::to_string(offset));
+      }
+      offset += n;
+      ++count;
+      --todo;
+    }
+  }
+
+  if (count % CHECKPOINT_INTERVAL == 0) {
+    _checkpoints.push_back(offset);
+  }
+  _size = count;
+}
+
+void UTF8CharStream::reset() {
+  _p = 0;
+  _index = 0;
+}
+
+void UTF8CharStream::consume() {
+  if (_index >= _size) {
+    assert(LA(1) == IntStream::EOF);
+    throw IllegalStateException("cannot consume EOF");
+  }
+
+  _p += sequenceLength(_data[_p]);
+  ++_index;
+}
+
+size_t UTF8CharStream::LA(ssize_t i) {
+  if (i == 0) {
+    return 0; // undefined
+  }
+
+  const unsigned char *p = _data + _p;
+  if (i > 0) {
+    if (_index + static_cast<size_t>(i) - 1 >= _size) {
+      return IntStream::EOF;
+    }
+
+    for (ssize_t k = 1; k < i; ++k) {
+      p += sequenceLength(*p);
+    }
+    return decode(p);
+  }
+
+  if (static_cast<size_t>(-i) > _index) {
+    return IntStream::EOF; // invalid; no char before first char
+  }
+
+  for (ssize_t k = 0; k < -i; ++k) {
+    do {
+      --p;
+    } while ((*p & 0xC0) == 0x80);
+  }
+  return decode(p);
+}
+
+size_t UTF8CharStream::index() {
+  return _index;
+}
+
+size_t UTF8CharStream::size() {
+  return _size;
+}
+
+ssize_t UTF8CharStream::mark() {
+  return -1;
+}
+
+void UTF8CharStream::release(ssize_t /* marker */) {
+}
+
+void UTF8CharStream::seek(size_t index) {
+  index = std::min(index, _size);
+  _p = byteOffset(index);
+  _index = index;
+}
+
+std::string UTF8CharStream::getText(const Interval &interval) {
+  if (interval.a < 0 || interval.b < 0) {
+    return "";
+  }
+
+  size_t start = static_cast<size_t>(interval.a);
+  size_t stop = static_cast<size_t>(interval.b);
+  if (stop >= _size) {
+    stop = _size - 1;
+  }
+
+  if (start >= _size || stop < start) {
+    return "";
+  }
+
+  size_t begin = byteOffset(start);
+  size_t end = begin;
+  for (size_t i = start; i <= stop; ++i) {
+    end += sequenceLength(_data[end]);
+  }
+  return std::string(reinterpret_cast<const char *>(_data) + begin, end - begin);
+}
+
+std::string UTF8CharStream::getSourceName() const {
+  if (name.empty()) {
+    return IntStream::UNKNOWN_SOURCE_NAME;
+  }
+  return name;
+}
+
+std::string UTF8CharStream::toString() const {
+  return std::string(reinterpret_cast<const char *>(_data), _length);
+}
+
+size_t UTF8CharStream::byteOffset(size_t index) const {
+  size_t current = (index / CHECKPOINT_INTERVAL) * CHECKPOINT_INTERVAL;
+  size_t offset = _checkpoints[index / CHECKPOINT_INTERVAL];
+
+  // Continue from the current position instead, if that is closer.
+  if (index >= _index && _index > current) {
+    current = _index;
+    offset = _p;
+  }
+
+  for (; current < index; ++current) {
+    offset += sequenceLength(_data[offset]);
+  }
+  return offset;
+}
@@ -0,0 +1,75 @@
+﻿/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "CharStream.h"
+
+namespace antlr4 {
+
+  /// A char stream which works directly on UTF-8 encoded bytes owned by the caller, without converting
+  /// them to UTF-32 first. Code points are decoded on the fly in LA() and consume(), while index() and
+  /// all intervals still count code points (like in ANTLRInputStream).
+  ///
+  /// The input is validated once on load. During that pass a sparse index of byte offsets is built
+  /// (one entry per CHECKPOINT_INTERVAL code points), which keeps seek() and getText() cheap.
+  /// The memory needed in addition to the input is therefore only a small fraction of its size.
+  class ANTLR4CPP_PUBLIC UTF8CharStream : public CharStream {
+  public:
+    /// The number of code points between two entries in the offset index.
+    static const size_t CHECKPOINT_INTERVAL = 1024;
+
+    /// What is name or source of this char stream?
+    std::string name;
+
+    /// The data must stay valid as long as this stream (or any token created from it) is in use.
+    /// A leading UTF-8 BOM is skipped. Throws IllegalArgumentException on invalid UTF-8.
+    UTF8CharStream(const char *data, size_t length);
+    virtual ~UTF8CharStream();
+
+    virtual void load(const char *data, size_t length);
+
+    /// Reset the stream so that it's in the same state it was
+    /// when the object was created *except* the data array is not
+    /// touched.
+    virtual void reset();
+    virtual void consume() override;
+    virtual size_t LA(ssize_t i) override;
+
+    virtual size_t index() override;
+    virtual size_t size() override;
+
+    /// mark/release do nothing; we have entire buffer.
+    virtual ssize_t mark() override;
+    virtual void release(ssize_t marker) override;
+
+    virtual void seek(size_t index) override;
+    virtual std::string getText(const misc::Interval &interval) override;
+    virtual std::string getSourceName() const override;
+    virtual std::string toString() const override;
+
+  protected:
+    const unsigned char *_data; // UTF-8, without BOM.
+    size_t _length; // In bytes.
+
+    /// The number of code points in _data.
+    size_t _size;
+
+    /// Byte offset of the next char (the one returned by LA(1)).
+    size_t _p;
+
+    /// Code point index of the next char.
+    size_t _index;
+
+    /// _checkpoints[i] is the byte offset of code point i * CHECKPOINT_INTERVAL (up to and including _size).
+    std::vector<size_t> _checkpoints;
+
+    UTF8CharStream();
+
+    /// Returns the byte offset of the code point with the given index (which must be <= _size).
+    size_t byteOffset(size_t index) const;
+  };
+
+} // namespace antlr4
@@ -3,6 +3,13 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
+#ifdef _WIN32
+  #include <io.h>
+#else
+  #include <errno.h>
+  #include <unistd.h>
+#endif
+
 #include "misc/Interval.h"
 #include "Exceptions.h"
 #include "support/StringUtils.h"
@@ -13,19 +20,41 @@ using namespace antlrcpp;
 using namespace antlr4;
 using namespace antlr4::misc;
 
-UnbufferedCharStream::UnbufferedCharStream(std::wistream &input) : _input(input) {
+UnbufferedCharStream::UnbufferedCharStream(std::wistream &input) {
   InitializeInstanceFields();
+  _input = &input;
 
   // The vector's size is what used to be n in Java code.
   fill(1); // prime
 }
 
+UnbufferedCharStream::UnbufferedCharStream(std::istream &input, size_t chunkSize) {
+  InitializeInstanceFields();
+  _byteInput = &input;
+  _chunkSize = chunkSize;
+
+  fill(1); // prime
+}
+
+UnbufferedCharStream::UnbufferedCharStream(int fileDescriptor, size_t chunkSize) {
+  InitializeInstanceFields();
+  _fileDescriptor = fileDescriptor;
+  _chunkSize = chunkSize;
+
+  fill(1); // prime
+}
+
+UnbufferedCharStream::UnbufferedCharStream(size_t chunkSize) {
+  InitializeInstanceFields();
+  _chunkSize = chunkSize;
+}
+
 void UnbufferedCharStream::consume() {
   if (LA(1) == EOF) {
     throw IllegalStateException("cannot consume EOF");
   }
 
-  // buf always has at least data[p==0] in this method due to ctor
+  // buf always has at least data[p==0] here, LA(1) above filled it if the ctor didn't prime
   _lastChar = _data[_p]; // track last char for LA(-1)
 
   if (_p == _data.size() - 1 && _numMarkers == 0) {
@@ -51,6 +80,10 @@ void UnbufferedCharStream::sync(size_t want) {
 }
 
 size_t UnbufferedCharStream::fill(size_t n) {
+  if (isByteOriented()) {
+    return fillFromBytes(n);
+  }
+
   for (size_t i = 0; i < n; i++) {
     if (_data.size() > 0 && _data.back() == 0xFFFF) {
       return i;
@@ -75,8 +108,35 @@ size_t UnbufferedCharStream::fill(size_t n) {
 
 char32_t UnbufferedCharStream::nextChar()  {
   wchar_t result = 0;
-  _input >> result;
-  return result;
+  if (!_input->get(result)) {
+    return 0xFFFF; // EOF marker, see fill().
+  }
+  return static_cast<char32_t>(result);
+}
+
+size_t UnbufferedCharStream::readBytes(char *buffer, size_t size) {
+  if (_byteInput != nullptr) {
+    _byteInput->read(buffer, static_cast<std::streamsize>(size));
+    if (_byteInput->bad()) {
+      throw IOException("cannot read from input stream");
+    }
+    return static_cast<size_t>(_byteInput->gcount());
+  }
+
+  while (true) {
+#ifdef _WIN32
+    int count = _read(_fileDescriptor, buffer, static_cast<unsigned int>(std::min<size_t>(size, INT_MAX)));
+#else
+    ssize_t count = read(_fileDescriptor, buffer, size);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+#endif
+    if (count < 0) {
+      throw IOException("cannot read from file descriptor " + std::to_string(_fileDescriptor));
+    }
+    return static_cast<size_t>(count);
+  }
 }
 
 void UnbufferedCharStream::add(char32_t c) {
@@ -109,7 +169,9 @@ size_t UnbufferedCharStream::LA(ssize_t i) {
 }
 
 ssize_t UnbufferedCharStream::mark() {
-  if (_numMarkers == 0) {
+  // Releasing the last marker doesn't always compact the buffer (see release()), so _lastCharBufferStart only
+  // corresponds to the current char if we are at the buffer start.
+  if (_numMarkers == 0 && _p == 0) {
     _lastCharBufferStart = _lastChar;
   }
 
@@ -125,7 +187,10 @@ void UnbufferedCharStream::release(ssize_t marker) {
   }
 
   _numMarkers--;
-  if (_numMarkers == 0 && _p > 0) {
+
+  // Compact only when at least half of the buffer is consumed. This keeps the cost per char constant
+  // when a large chunk of input is buffered and a mark is released after every token.
+  if (_numMarkers == 0 && _p > 0 && _p >= _data.size() / 2) {
     _data.erase(0, _p);
     _p = 0;
     _lastCharBufferStart = _lastChar;
@@ -178,7 +243,7 @@ std::string UnbufferedCharStream::getSourceName() const {
 }
 
 std::string UnbufferedCharStream::getText(const misc::Interval &interval) {
-  if (interval.a < 0 || interval.b >= interval.a - 1) {
+  if (interval.a < 0 || interval.b < interval.a - 1) {
     throw IllegalArgumentException("invalid interval");
   }
 
@@ -195,17 +260,92 @@ std::string UnbufferedCharStream::getText(const misc::Interval &interval) {
   }
   // convert from absolute to local index
   size_t i = interval.a - bufferStartIndex;
-  return utf32_to_utf8(_data.substr(i, interval.length()));
+  auto data = reinterpret_cast<const char32_t *>(_data.data()) + i;
+  return utf32_to_utf8(data, data + interval.length());
+}
+
+std::string UnbufferedCharStream::toString() const {
+  size_t length = _data.size();
+  if (length > 0 && _data.back() == 0xFFFF) {
+    --length;
+  }
+  auto data = reinterpret_cast<const char32_t *>(_data.data());
+  return utf32_to_utf8(data, data + length);
 }
 
 size_t UnbufferedCharStream::getBufferStartIndex() const {
   return _currentCharIndex - _p;
 }
 
+bool UnbufferedCharStream::isByteOriented() const {
+  return _input == nullptr;
+}
+
+size_t UnbufferedCharStream::fillFromBytes(size_t n) {
+  size_t added = 0;
+  while (added < n) {
+    if (!_data.empty() && _data.back() == 0xFFFF) {
+      break;
+    }
+
+    // Append a new chunk to the bytes left over from the last round (at most an incomplete sequence).
+    size_t pending = _bytes.size();
+    _bytes.resize(pending + _chunkSize);
+    size_t count = readBytes(&_bytes[pending], _chunkSize);
+    _bytes.resize(pending + count);
+
+    if (count == 0) {
+      if (!_bytes.empty()) {
+        throw std::range_error("incomplete UTF-8 sequence at byte offset " + std::to_string(_byteOffset));
+      }
+      add(0xFFFF);
+      break;
+    }
+
+    size_t start = 0;
+    if (_byteOffset == 0 && _bytes.compare(0, 3, "\xef\xbb\xbf", 3) == 0) {
+      start = 3; // Skip the UTF-8 BOM.
+    } else if (_byteOffset == 0 && _bytes.size() < 3 && std::string("\xef\xbb\xbf").compare(0, _bytes.size(), _bytes) == 0) {
+      continue; // Could still become a BOM.
+    }
+
+    // Find the end of the last complete sequence. Continuation bytes are 10xxxxxx.
+    size_t end = _bytes.size();
+    size_t lead = end;
+    while (lead > start && end - lead < 3 && (static_cast<unsigned char>(_bytes[lead - 1]) & 0xC0) == 0x80) {
+      --lead;
+    }
+    if (lead > start) {
+      unsigned char c = static_cast<unsigned char>(_bytes[lead - 1]);
+      size_t length = (c < 0x80) ? 1 : (c < 0xE0) ? 2 : (c < 0xF0) ? 3 : 4;
+      if (end - lead + 1 < length) {
+        end = lead - 1; // Keep the incomplete sequence for the next round.
+      }
+    }
+
+    size_t errorOffset;
+    if (!utf8_to_utf32(_bytes.data() + start, _bytes.data() + end, _decoded, errorOffset)) {
+      throw std::range_error("invalid UTF-8 sequence at byte offset " + std::to_string(_byteOffset + start + errorOffset));
+    }
+    _data.append(reinterpret_cast<const storage_type *>(_decoded.data()), _decoded.size());
+    added += _decoded.size();
+
+    _byteOffset += end;
+    _bytes.erase(0, end);
+  }
+
+  return added;
+}
+
 void UnbufferedCharStream::InitializeInstanceFields() {
   _p = 0;
   _numMarkers = 0;
-  _lastChar = 0;
-  _lastCharBufferStart = 0;
+  _lastChar = EOF; // Nothing before the first char.
+  _lastCharBufferStart = EOF;
   _currentCharIndex = 0;
+  _input = nullptr;
+  _byteInput = nullptr;
+  _fileDescriptor = -1;
+  _chunkSize = DEFAULT_CHUNK_SIZE;
+  _byteOffset = 0;
 }
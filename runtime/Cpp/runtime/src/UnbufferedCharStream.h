@@ -13,13 +13,26 @@ namespace antlr4 {
   /// for efficiency and also buffers while a mark exists (set by the
   /// lookahead prediction in parser). "Unbuffered" here refers to fact
   /// that it doesn't buffer all data, not that's it's on demand loading of char.
+  ///
+  /// The stream can either read wide chars one by one from a std::wistream, or UTF-8 encoded bytes
+  /// from a std::istream or a file descriptor (e.g. a pipe). Bytes are read in chunks and decoded in bulk,
+  /// so only the current chunk and the marked window stay in memory.
   class ANTLR4CPP_PUBLIC UnbufferedCharStream : public CharStream {
   public:
+    /// The number of bytes read at once from byte oriented input.
+    static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
     /// The name or source of this char stream.
     std::string name;
 
     UnbufferedCharStream(std::wistream &input);
 
+    /// Reads UTF-8 encoded bytes (with or w/o BOM) from the given stream.
+    UnbufferedCharStream(std::istream &input, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /// Reads UTF-8 encoded bytes from the given file descriptor, which is not closed by this stream.
+    UnbufferedCharStream(int fileDescriptor, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
     virtual void consume() override;
     virtual size_t LA(ssize_t i) override;
 
@@ -47,7 +60,15 @@ namespace antlr4 {
     virtual std::string getSourceName() const override;
     virtual std::string getText(const misc::Interval &interval) override;
 
+    /// Returns the text currently held in the buffer (not the entire input).
+    virtual std::string toString() const override;
+
   protected:
+    /// For subclasses which override readBytes(). Unlike the public constructors this one doesn't read
+    /// anything (virtual calls don't reach the subclass during construction). The buffer is filled by the
+    /// first call to LA(), consume() or seek() instead.
+    UnbufferedCharStream(size_t chunkSize);
+
     /// A moving window buffer of the data being scanned. While there's a marker,
     /// we keep adding to buffer. Otherwise, <seealso cref="#consume consume()"/> resets so
     /// we start filling at index 0 again.
@@ -93,7 +114,17 @@ namespace antlr4 {
     /// </summary>
     size_t _currentCharIndex;
 
-    std::wistream &_input;
+    /// The source of the input. Only one of them is set.
+    std::wistream *_input;
+    std::istream *_byteInput;
+    int _fileDescriptor;
+
+    /// Bytes read from byte oriented input, which do not yet form a complete UTF-8 sequence.
+    std::string _bytes;
+    size_t _chunkSize;
+
+    /// The number of bytes decoded so far (for error messages).
+    size_t _byteOffset;
 
     /// <summary>
     /// Make sure we have 'want' elements from current position <seealso cref="#p p"/>.
@@ -113,10 +144,20 @@ namespace antlr4 {
     /// Override to provide different source of characters than
     /// <seealso cref="#input input"/>.
     virtual char32_t nextChar();
+
+    /// Override to provide a different source of UTF-8 bytes (use the protected constructor then).
+    /// Returns the number of bytes read into buffer, which is 0 only at the end of the input.
+    virtual size_t readBytes(char *buffer, size_t size);
+
     virtual void add(char32_t c);
     size_t getBufferStartIndex() const;
 
   private:
+    UTF32String _decoded; // Scratch buffer for decoding.
+
+    bool isByteOriented() const;
+    size_t fillFromBytes(size_t n);
+
     void InitializeInstanceFields();
   };
 
@@ -10,6 +10,7 @@
 #include <atomic>
 #include <codecvt>
 #include <chrono>
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <iterator>
@@ -23,8 +24,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <sstream>
+#include <stdexcept>
 #include <stack>
 #include <string>
+#include <string.h>
 #include <typeinfo>
 #include <type_traits>
 #include <unordered_map>
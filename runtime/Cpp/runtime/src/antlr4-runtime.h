@@ -25,6 +25,10 @@
 #include "DiagnosticErrorListener.h"
 #include "Exceptions.h"
 #include "FailedPredicateException.h"
+#include "IncrementalLexer.h"
+#include "IncrementalParser.h"
+#include "IncrementalParserRuleContext.h"
+#include "IncrementalTokenStream.h"
 #include "InputMismatchException.h"
 #include "IntStream.h"
 #include "InterpreterRuleContext.h"
@@ -32,6 +36,7 @@
 #include "LexerInterpreter.h"
 #include "LexerNoViableAltException.h"
 #include "ListTokenSource.h"
+#include "MemoryMappedFileStream.h"
 #include "NoViableAltException.h"
 #include "Parser.h"
 #include "ParserInterpreter.h"
@@ -42,11 +47,13 @@
 #include "RuleContext.h"
 #include "RuleContextWithAltNum.h"
 #include "RuntimeMetaData.h"
+#include "SlidingWindowTokenStream.h"
 #include "Token.h"
 #include "TokenFactory.h"
 #include "TokenSource.h"
 #include "TokenStream.h"
 #include "TokenStreamRewriter.h"
+#include "UTF8CharStream.h"
 #include "UnbufferedCharStream.h"
 #include "UnbufferedTokenStream.h"
 #include "Vocabulary.h"
@@ -77,6 +84,7 @@
 #include "atn/EmptyPredictionContext.h"
 #include "atn/EpsilonTransition.h"
 #include "atn/ErrorInfo.h"
+#include "atn/FollowSetCache.h"
 #include "atn/LL1Analyzer.h"
 #include "atn/LexerATNConfig.h"
 #include "atn/LexerATNSimulator.h"
@@ -135,33 +143,34 @@
 #include "support/StringUtils.h"
 #include "support/guid.h"
 #include "tree/AbstractParseTreeVisitor.h"
+#include "tree/ChildList.h"
+#include "tree/DenseParseTreeProperty.h"
 #include "tree/ErrorNode.h"
 #include "tree/ErrorNodeImpl.h"
+#include "tree/ParallelParseTreeWalker.h"
 #include "tree/ParseTree.h"
+#include "tree/ParseTreeDispatcher.h"
 #include "tree/ParseTreeListener.h"
 #include "tree/ParseTreeProperty.h"
+#include "tree/ParseTreeRange.h"
 #include "tree/ParseTreeVisitor.h"
 #include "tree/ParseTreeWalker.h"
 #include "tree/TerminalNode.h"
 #include "tree/TerminalNodeImpl.h"
 #include "tree/Trees.h"
+#include "tree/TypedParseTreeVisitor.h"
 #include "tree/pattern/Chunk.h"
 #include "tree/pattern/ParseTreeMatch.h"
 #include "tree/pattern/ParseTreePattern.h"
 #include "tree/pattern/ParseTreePatternMatcher.h"
+#include "tree/pattern/ParseTreePatternSet.h"
 #include "tree/pattern/RuleTagToken.h"
 #include "tree/pattern/TagChunk.h"
 #include "tree/pattern/TextChunk.h"
 #include "tree/pattern/TokenTagToken.h"
 #include "tree/xpath/XPath.h"
-#include "tree/xpath/XPathElement.h"
+#include "tree/xpath/XPathIndex.h"
 #include "tree/xpath/XPathLexer.h"
 #include "tree/xpath/XPathLexerErrorListener.h"
-#include "tree/xpath/XPathRuleAnywhereElement.h"
-#include "tree/xpath/XPathRuleElement.h"
-#include "tree/xpath/XPathTokenAnywhereElement.h"
-#include "tree/xpath/XPathTokenElement.h"
-#include "tree/xpath/XPathWildcardAnywhereElement.h"
-#include "tree/xpath/XPathWildcardElement.h"
 
 
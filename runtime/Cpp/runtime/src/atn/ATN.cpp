@@ -58,6 +58,7 @@ ATN& ATN::operator = (ATN &other) NOEXCEPT {
   ruleToTokenType = other.ruleToTokenType;
   lexerActions = other.lexerActions;
   modeToStartState = other.modeToStartState;
+  _followSetCache.clear();
 
   return *this;
 }
@@ -77,6 +78,8 @@ ATN& ATN::operator = (ATN &&other) NOEXCEPT {
   ruleToTokenType = std::move(other.ruleToTokenType);
   lexerActions = std::move(other.lexerActions);
   modeToStartState = std::move(other.modeToStartState);
+  _followSetCache.clear();
+  other._followSetCache.clear();
 
   return *this;
 }
@@ -134,34 +137,42 @@ misc::IntervalSet ATN::getExpectedTokens(size_t stateNumber, RuleContext *contex
     throw IllegalArgumentException("Invalid state number.");
   }
 
-  RuleContext *ctx = context;
   ATNState *s = states.at(stateNumber);
-  misc::IntervalSet following = nextTokens(s);
-  if (!following.contains(Token::EPSILON)) {
-    return following;
+  const misc::IntervalSet &initial = nextTokens(s);
+  if (!initial.contains(Token::EPSILON)) {
+    return initial;
   }
 
-  misc::IntervalSet expected;
-  expected.addAll(following);
-  expected.remove(Token::EPSILON);
-  while (ctx && ctx->invokingState != ATNState::INVALID_STATE_NUMBER && following.contains(Token::EPSILON)) {
-    ATNState *invokingState = states.at(ctx->invokingState);
-    RuleTransition *rt = static_cast<RuleTransition*>(invokingState->transitions[0]);
-    following = nextTokens(rt->followState);
+  // Everything below depends on the invocation stack and is expensive, so cache it.
+  return _followSetCache.get(stateNumber, context, [&]() {
+    RuleContext *ctx = context;
+    misc::IntervalSet following = initial;
+    misc::IntervalSet expected;
     expected.addAll(following);
     expected.remove(Token::EPSILON);
+    while (ctx && ctx->invokingState != ATNState::INVALID_STATE_NUMBER && following.contains(Token::EPSILON)) {
+      ATNState *invokingState = states.at(ctx->invokingState);
+      RuleTransition *rt = static_cast<RuleTransition*>(invokingState->transitions[0]);
+      following = nextTokens(rt->followState);
+      expected.addAll(following);
+      expected.remove(Token::EPSILON);
+
+      if (ctx->parent == nullptr) {
+        break;
+      }
+      ctx = static_cast<RuleContext *>(ctx->parent);
+    }
 
-    if (ctx->parent == nullptr) {
-      break;
+    if (following.contains(Token::EPSILON)) {
+      expected.add(Token::EOF);
     }
-    ctx = static_cast<RuleContext *>(ctx->parent);
-  }
 
-  if (following.contains(Token::EPSILON)) {
-    expected.add(Token::EOF);
-  }
+    return expected;
+  });
+}
 
-  return expected;
+FollowSetCache& ATN::getFollowSetCache() const {
+  return _followSetCache;
 }
 
 std::string ATN::toString() const {
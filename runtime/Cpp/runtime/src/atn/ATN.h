@@ -6,6 +6,7 @@
 #pragma once
 
 #include "RuleContext.h"
+#include "atn/FollowSetCache.h"
 
 namespace antlr4 {
 namespace atn {
@@ -100,12 +101,18 @@ namespace atn {
     /// specified state in the specified context. </returns>
     /// <exception cref="IllegalArgumentException"> if the ATN does not contain a state with
     /// number {@code stateNumber} </exception>
+    /// The result is cached per invocation stack of {@code context} (see getFollowSetCache()).
     virtual misc::IntervalSet getExpectedTokens(size_t stateNumber, RuleContext *context) const;
 
+    /// The cache for the token sets computed along a rule invocation stack, like the expected tokens
+    /// and the error recovery set of the DefaultErrorStrategy.
+    FollowSetCache& getFollowSetCache() const;
+
     std::string toString() const;
 
   private:
     mutable std::mutex _mutex;
+    mutable FollowSetCache _followSetCache;
   };
 
 } // namespace atn
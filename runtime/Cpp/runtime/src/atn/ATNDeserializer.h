@@ -26,6 +26,11 @@ namespace atn {
     static Guid toUUID(const unsigned short *data, size_t offset);
 
     virtual ATN deserialize(const std::vector<uint16_t> &input);
+
+    /// Deserializes an ATN from a static table, like the ones generated with the staticATN option, so
+    /// that no vector needs to be constructed by the caller. The values are still copied once internally,
+    /// to undo the offset applied by the serializer.
+    virtual ATN deserialize(const uint16_t *input, size_t length);
     virtual void verifyATN(const ATN &atn);
 
     static void checkCondition(bool condition);
@@ -0,0 +1,96 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "RuleContext.h"
+#include "atn/ATNState.h"
+#include "misc/MurmurHash.h"
+
+#include "atn/FollowSetCache.h"
+
+using namespace antlr4;
+using namespace antlr4::atn;
+
+bool FollowSetCache::Entry::matches(size_t stateNumber_, RuleContext *context) const {
+  if (stateNumber != stateNumber_) {
+    return false;
+  }
+
+  RuleContext *ctx = context;
+  for (size_t invokingState : invokingStates) {
+    if (ctx == nullptr || ctx->invokingState != invokingState) {
+      return false;
+    }
+    ctx = static_cast<RuleContext *>(ctx->parent);
+  }
+  return ctx == nullptr || ctx->invokingState == ATNState::INVALID_STATE_NUMBER;
+}
+
+size_t FollowSetCache::hashCode(size_t stateNumber, RuleContext *context) {
+  size_t hash = misc::MurmurHash::initialize();
+  hash = misc::MurmurHash::update(hash, stateNumber);
+  size_t count = 1;
+  for (RuleContext *ctx = context; ctx != nullptr && ctx->invokingState != ATNState::INVALID_STATE_NUMBER;
+       ctx = static_cast<RuleContext *>(ctx->parent)) {
+    hash = misc::MurmurHash::update(hash, ctx->invokingState);
+    ++count;
+  }
+  return misc::MurmurHash::finish(hash, count);
+}
+
+FollowSetCache::FollowSetCache(size_t maxSize) : _maxSize(maxSize) {
+}
+
+misc::IntervalSet FollowSetCache::get(size_t stateNumber, RuleContext *context,
+  const std::function<misc::IntervalSet ()> &compute) {
+  if (_maxSize == 0) {
+    return compute();
+  }
+
+  size_t hash = hashCode(stateNumber, context);
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto range = _sets.equal_range(hash);
+    for (auto iterator = range.first; iterator != range.second; ++iterator) {
+      if (iterator->second.matches(stateNumber, context)) {
+        return iterator->second.set;
+      }
+    }
+  }
+
+  // Computed without holding the lock. Another thread might add the same set in the meantime, which is harmless.
+  Entry entry { stateNumber, {}, compute() };
+  for (RuleContext *ctx = context; ctx != nullptr && ctx->invokingState != ATNState::INVALID_STATE_NUMBER;
+       ctx = static_cast<RuleContext *>(ctx->parent)) {
+    entry.invokingStates.push_back(ctx->invokingState);
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_sets.size() >= _maxSize) {
+    _sets.clear();
+  }
+  return _sets.emplace(hash, std::move(entry))->second.set;
+}
+
+size_t FollowSetCache::size() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _sets.size();
+}
+
+void FollowSetCache::clear() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _sets.clear();
+}
+
+void FollowSetCache::setMaxSize(size_t maxSize) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _maxSize = maxSize;
+  if (_sets.size() > _maxSize) {
+    _sets.clear();
+  }
+}
+
+size_t FollowSetCache::getMaxSize() const {
+  return _maxSize;
+}
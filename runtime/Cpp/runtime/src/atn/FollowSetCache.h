@@ -0,0 +1,57 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "misc/IntervalSet.h"
+
+namespace antlr4 {
+namespace atn {
+
+  /// A bounded, thread safe cache for token sets which depend on an ATN state and the rule invocation stack
+  /// of a context, like the expected tokens (ATN::getExpectedTokens()) and the error recovery set
+  /// (DefaultErrorStrategy::getErrorRecoverySet()). Computing such a set means walking up the context
+  /// and merging the follow sets of all invoking states, which is repeated over and over for the same
+  /// stacks when the input contains many syntax errors.
+  ///
+  /// Entries are keyed by the state number and the invoking states of the context chain, so the cache
+  /// can be shared by all parsers using the same ATN. It is cleared when it exceeds its maximum size.
+  class ANTLR4CPP_PUBLIC FollowSetCache {
+  public:
+    static const size_t DEFAULT_MAX_SIZE = 1024;
+
+    FollowSetCache(size_t maxSize = DEFAULT_MAX_SIZE);
+
+    /// Returns the set cached for the given state number and the invocation stack of context (which can be null).
+    /// If there's none yet, computes it by calling compute and adds it to the cache.
+    misc::IntervalSet get(size_t stateNumber, RuleContext *context, const std::function<misc::IntervalSet ()> &compute);
+
+    size_t size() const;
+    void clear();
+
+    /// Setting a max size of 0 disables the cache.
+    void setMaxSize(size_t maxSize);
+    size_t getMaxSize() const;
+
+  private:
+    struct Entry {
+      size_t stateNumber;
+      std::vector<size_t> invokingStates;
+      misc::IntervalSet set;
+
+      bool matches(size_t stateNumber, RuleContext *context) const;
+    };
+
+    static size_t hashCode(size_t stateNumber, RuleContext *context);
+
+    mutable std::mutex _mutex;
+
+    // Keyed by hash code, so lookups can compare the entries with the context chain without creating a key.
+    std::unordered_multimap<size_t, Entry> _sets;
+    std::atomic<size_t> _maxSize;
+  };
+
+} // namespace atn
+} // namespace antlr4
@@ -66,6 +66,7 @@ void LexerATNSimulator::copyState(LexerATNSimulator *simulator) {
   _line = simulator->_line;
   _mode = simulator->_mode;
   _startIndex = simulator->_startIndex;
+  _maxLookaheadIndex = simulator->_maxLookaheadIndex;
 }
 
 size_t LexerATNSimulator::match(CharStream *input, size_t mode) {
@@ -87,12 +88,38 @@ size_t LexerATNSimulator::match(CharStream *input, size_t mode) {
   }
 }
 
+size_t LexerATNSimulator::skipUnmatchableChars(CharStream *input, size_t mode) {
+  dfa::DFAState *s0 = _decisionToDFA[mode].s0;
+  if (s0 == nullptr || s0->isAcceptState) { // A zero length token would match anywhere.
+    return 0;
+  }
+
+  // Remembers the chars already looked up, which saves locking the DFA edges for each char.
+  std::bitset<MAX_DFA_EDGE + 1> unmatchable;
+  size_t count = 0;
+  while (true) {
+    size_t t = input->LA(1);
+    if (t > MAX_DFA_EDGE) { // Also covers EOF.
+      return count;
+    }
+    if (!unmatchable[t]) {
+      if (getExistingTargetState(s0, t) != ERROR.get()) {
+        return count;
+      }
+      unmatchable[t] = true;
+    }
+    consume(input);
+    ++count;
+  }
+}
+
 void LexerATNSimulator::reset() {
   _prevAccept.reset();
   _startIndex = 0;
   _line = 1;
   _charPositionInLine = 0;
   _mode = Lexer::DEFAULT_MODE;
+  _maxLookaheadIndex = 0;
 }
 
 void LexerATNSimulator::clearDFA() {
@@ -177,6 +204,11 @@ size_t LexerATNSimulator::execATN(CharStream *input, dfa::DFAState *ds0) {
     s = target; // flip; current DFA target becomes new src/from state
   }
 
+  // The character at the current index has been examined (as t) and ended the match.
+  if (input->index() > _maxLookaheadIndex) {
+    _maxLookaheadIndex = input->index();
+  }
+
   return failOrAccept(input, s->configs.get(), t);
 }
 
@@ -232,6 +264,9 @@ size_t LexerATNSimulator::failOrAccept(CharStream *input, ATNConfigSet *reach, s
       return Token::EOF;
     }
 
+    if (_recog != nullptr && _recog->isExceptionFreeRecovery()) {
+      return Token::INVALID_TYPE; // Lexer::nextToken() recovers.
+    }
     throw LexerNoViableAltException(_recog, input, _startIndex, reach);
   }
 }
@@ -602,6 +637,14 @@ void LexerATNSimulator::setCharPositionInLine(size_t charPositionInLine) {
   _charPositionInLine = charPositionInLine;
 }
 
+size_t LexerATNSimulator::getMaxLookaheadIndex() const {
+  return _maxLookaheadIndex;
+}
+
+void LexerATNSimulator::setMaxLookaheadIndex(size_t index) {
+  _maxLookaheadIndex = index;
+}
+
 void LexerATNSimulator::consume(CharStream *input) {
   size_t curChar = input->LA(1);
   if (curChar == '\n') {
@@ -625,4 +668,5 @@ void LexerATNSimulator::InitializeInstanceFields() {
   _line = 1;
   _charPositionInLine = 0;
   _mode = antlr4::Lexer::DEFAULT_MODE;
+  _maxLookaheadIndex = 0;
 }
@@ -81,6 +81,11 @@ namespace atn {
     /// Used during DFA/ATN exec to record the most recent accept configuration info.
     SimState _prevAccept;
 
+    /// The highest input index examined by any match() call since the last reset. This includes
+    /// the lookahead character which ended the longest match, so it tells which part of the input
+    /// a token depends on (used for incremental relexing).
+    size_t _maxLookaheadIndex;
+
   public:
     static int match_calls;
 
@@ -89,7 +94,16 @@ namespace atn {
     virtual ~LexerATNSimulator () {}
 
     virtual void copyState(LexerATNSimulator *simulator);
+
+    /// Returns the type of the token matched at the current input position. If no token matches, a
+    /// LexerNoViableAltException is thrown, or Token::INVALID_TYPE is returned when the lexer uses
+    /// exception free recovery (see Lexer::setExceptionFreeRecovery()).
     virtual size_t match(CharStream *input, size_t mode);
+
+    /// Consumes characters as long as the DFA of the given mode already knows that no token can start with them,
+    /// and returns how many were consumed. Lets the lexer skip a run of unrecognized characters without trying
+    /// to match a token at each of them.
+    virtual size_t skipUnmatchableChars(CharStream *input, size_t mode);
     virtual void reset() override;
 
     virtual void clearDFA() override;
@@ -199,6 +213,8 @@ namespace atn {
     virtual void setLine(size_t line);
     virtual size_t getCharPositionInLine();
     virtual void setCharPositionInLine(size_t charPositionInLine);
+    virtual size_t getMaxLookaheadIndex() const;
+    virtual void setMaxLookaheadIndex(size_t index);
     virtual void consume(CharStream *input);
     virtual std::string getTokenName(size_t t);
 
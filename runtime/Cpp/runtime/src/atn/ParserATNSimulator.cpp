@@ -86,12 +86,13 @@ size_t ParserATNSimulator::adaptivePredict(TokenStream *input, size_t decision,
 
   // Now we are certain to have a specific decision's DFA
   // But, do we still need an initial state?
-  auto onExit = finally([this, input, index, m] {
+  auto cleanUp = [this, input, index, m] {
     mergeCache.clear(); // wack cache after each prediction
     _dfa = nullptr;
     input->seek(index);
     input->release(m);
-  });
+  };
+  auto onExit = finally(cleanUp);
 
   dfa::DFAState *s0;
   if (dfa.isPrecedenceDfa()) {
@@ -141,6 +142,14 @@ size_t ParserATNSimulator::adaptivePredict(TokenStream *input, size_t decision,
   // We can start with an existing DFA.
   size_t alt = execATN(dfa, s0, input, index, outerContext != nullptr ? outerContext : &ParserRuleContext::EMPTY);
 
+  if (_predictionError != nullptr) {
+    // Recover in the same state as after a thrown exception, that is, with the input restored.
+    Ref<NoViableAltException> e = std::move(_predictionError);
+    onExit.disable();
+    cleanUp();
+    parser->recoverFromError(*e);
+  }
+
   return alt;
 }
 
@@ -183,7 +192,7 @@ size_t ParserATNSimulator::execATN(dfa::DFA &dfa, dfa::DFAState *s0, TokenStream
         return alt;
       }
 
-      throw e;
+      return failPrediction(e);
     }
 
     if (D->requiresFullContext && _mode != PredictionMode::SLL) {
@@ -236,7 +245,7 @@ size_t ParserATNSimulator::execATN(dfa::DFA &dfa, dfa::DFAState *s0, TokenStream
       BitSet alts = evalSemanticContext(D->predicates, outerContext, true);
       switch (alts.count()) {
         case 0:
-          throw noViableAlt(input, outerContext, D->configs.get(), startIndex, false);
+          return failPrediction(noViableAlt(input, outerContext, D->configs.get(), startIndex, false));
 
         case 1:
           return alts.nextSetBit(0);
@@ -357,7 +366,7 @@ size_t ParserATNSimulator::execATNWithFullContext(dfa::DFA &dfa, dfa::DFAState *
       if (alt != ATN::INVALID_ALT_NUMBER) {
         return alt;
       }
-      throw e;
+      return failPrediction(e);
     }
     if (previous != s0) // Don't delete the start set.
         delete previous;
@@ -1228,6 +1237,15 @@ NoViableAltException ParserATNSimulator::noViableAlt(TokenStream *input, ParserR
   return NoViableAltException(parser, input, input->get(startIndex), input->LT(1), configs, outerContext, deleteConfigs);
 }
 
+size_t ParserATNSimulator::failPrediction(const NoViableAltException &e) {
+  if (parser == nullptr || !parser->isExceptionFreeRecovery()) {
+    throw e;
+  }
+
+  _predictionError = std::make_shared<NoViableAltException>(e);
+  return ATN::INVALID_ALT_NUMBER;
+}
+
 size_t ParserATNSimulator::getUniqueAlt(ATNConfigSet *configs) {
   size_t alt = ATN::INVALID_ALT_NUMBER;
   for (auto &c : configs->configs) {
@@ -386,6 +386,9 @@ namespace atn {
     size_t _startIndex;
     ParserRuleContext *_outerContext;
     dfa::DFA *_dfa; // Reference into the decisionToDFA vector.
+
+    // With exception free recovery: the error of the current prediction, handled once the input is restored.
+    Ref<NoViableAltException> _predictionError;
     
     /// <summary>
     /// Performs ATN simulation to compute a predicted alternative based
@@ -838,6 +841,10 @@ namespace atn {
     virtual NoViableAltException noViableAlt(TokenStream *input, ParserRuleContext *outerContext,
                                               ATNConfigSet *configs, size_t startIndex, bool deleteConfigs);
 
+    /// Throws e. For parsers with exception free recovery it instead keeps e until adaptivePredict() has
+    /// restored the input position and returns ATN::INVALID_ALT_NUMBER.
+    size_t failPrediction(const NoViableAltException &e);
+
     static size_t getUniqueAlt(ATNConfigSet *configs);
 
     /// <summary>
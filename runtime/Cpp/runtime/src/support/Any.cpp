@@ -9,5 +9,6 @@ using namespace antlrcpp;
 
 Any::~Any()
 {
-    delete _ptr;
+  if (_manager != nullptr && !_manager->isInline)
+    _manager->destroy(_storage.ptr);
 }
@@ -19,50 +19,51 @@ namespace antlrcpp {
 template<class T>
   using StorageType = typename std::decay<T>::type;
 
+// Small trivially copyable values (numbers, bools, pointers, enums and small POD structs) are stored inline,
+// everything else on the heap. A null Any (default constructed, from nullptr or moved from) holds nothing.
 struct ANTLR4CPP_PUBLIC Any
 {
-  bool isNull() const { return _ptr == nullptr; }
-  bool isNotNull() const { return _ptr != nullptr; }
+  bool isNull() const { return _manager == nullptr; }
+  bool isNotNull() const { return _manager != nullptr; }
 
-  Any() : _ptr(nullptr) {
+  Any() : _manager(nullptr) {
   }
 
-  Any(Any& that) : _ptr(that.clone()) {
+  Any(Any& that) {
+    copyFrom(that);
   }
 
-  Any(Any&& that) : _ptr(that._ptr) {
-    that._ptr = nullptr;
+  Any(Any&& that) {
+    moveFrom(that);
   }
 
-  Any(const Any& that) : _ptr(that.clone()) {
+  Any(const Any& that) {
+    copyFrom(that);
   }
 
-  Any(const Any&& that) : _ptr(that.clone()) {
+  // Only here to keep the template constructor from taking const rvalues, which can't be moved from.
+  Any(const Any&& that) {
+    copyFrom(that);
   }
 
   template<typename U>
-  Any(U&& value) : _ptr(new Derived<StorageType<U>>(std::forward<U>(value))) {
+  Any(U&& value) {
+    construct<StorageType<U>>(std::forward<U>(value));
   }
 
   template<class U>
   bool is() const {
-    auto derived = getDerived<U>(false);
-
-    return derived != nullptr;
+    return hasType<StorageType<U>>();
   }
 
   template<class U>
   StorageType<U>& as() {
-    auto derived = getDerived<U>(true);
-
-    return derived->value;
+    return *getValue<U>();
   }
 
   template<class U>
   const StorageType<U>& as() const {
-    auto derived = getDerived<U>(true);
-
-    return derived->value;
+    return *getValue<U>();
   }
 
   template<class U>
@@ -76,23 +77,20 @@ struct ANTLR4CPP_PUBLIC Any
   }
 
   Any& operator = (const Any& a) {
-    if (_ptr == a._ptr)
+    if (this == &a)
       return *this;
 
-    auto old_ptr = _ptr;
-    _ptr = a.clone();
-
-    if (old_ptr)
-      delete old_ptr;
+    Any copy(a);
+    swap(copy);
 
     return *this;
   }
 
   Any& operator = (Any&& a) {
-    if (_ptr == a._ptr)
+    if (this == &a)
       return *this;
 
-    std::swap(_ptr, a._ptr);
+    swap(a);
 
     return *this;
   }
@@ -100,66 +98,118 @@ struct ANTLR4CPP_PUBLIC Any
   virtual ~Any();
 
   virtual bool equals(Any other) const {
-    return _ptr == other._ptr;
+    // other is always a copy, so only two null values are the same.
+    return isNull() && other.isNull();
   }
 
 private:
-  struct Base {
-    virtual ~Base() {};
-    virtual Base* clone() const = 0;
+  // Describes a stored type. There's one instance for each type, so comparing the addresses is enough
+  // for a type check, except when the type is used across shared library boundaries.
+  struct Manager {
+    const std::type_info &type;
+    bool isInline;
+
+    // Only for values on the heap. clone returns nullptr if the value can't be copied without exceptions.
+    void* (*clone)(const void *value);
+    void (*destroy)(void *value);
+  };
+
+  union Storage {
+    void *ptr;
+    double d;
+    long long ll;
+    char buffer[2 * sizeof(void *)];
   };
 
   template<typename T>
-  struct Derived : Base
-  {
-    template<typename U> Derived(U&& value_) : value(std::forward<U>(value_)) {
-    }
+  struct Handler {
+    static const bool isInline = std::is_trivially_copyable<T>::value && sizeof(T) <= sizeof(Storage) &&
+      alignof(Storage) % alignof(T) == 0;
+    static const Manager manager;
 
-    T value;
+    static void* clone(const void *value) {
+      return cloneValue<>(value);
+    }
 
-    Base* clone() const {
-      return clone<>();
+    static void destroy(void *value) {
+      delete static_cast<T *>(value);
     }
 
   private:
     template<int N = 0, typename std::enable_if<N == N && std::is_nothrow_copy_constructible<T>::value, int>::type = 0>
-    Base* clone() const {
-      return new Derived<T>(value);
+    static void* cloneValue(const void *value) {
+      return new T(*static_cast<const T *>(value));
     }
 
     template<int N = 0, typename std::enable_if<N == N && !std::is_nothrow_copy_constructible<T>::value, int>::type = 0>
-    Base* clone() const {
+    static void* cloneValue(const void * /*value*/) {
       return nullptr;
     }
-
   };
 
-  Base* clone() const
-  {
-    if (_ptr)
-      return _ptr->clone();
-    else
-      return nullptr;
+  const Manager *_manager;
+  Storage _storage;
+
+  template<typename T, typename U, typename std::enable_if<Handler<T>::isInline, int>::type = 0>
+  void construct(U&& value) {
+    new (&_storage) T(std::forward<U>(value));
+    _manager = &Handler<T>::manager;
+  }
+
+  template<typename T, typename U, typename std::enable_if<!Handler<T>::isInline, int>::type = 0>
+  void construct(U&& value) {
+    _storage.ptr = new T(std::forward<U>(value));
+    _manager = &Handler<T>::manager;
+  }
+
+  void copyFrom(const Any &that) {
+    _manager = that._manager;
+    if (_manager == nullptr || _manager->isInline) {
+      _storage = that._storage;
+    } else {
+      _storage.ptr = _manager->clone(that._storage.ptr);
+      if (_storage.ptr == nullptr)
+        _manager = nullptr;
+    }
+  }
+
+  void moveFrom(Any &that) {
+    _manager = that._manager;
+    _storage = that._storage;
+    that._manager = nullptr;
+  }
+
+  void swap(Any &that) {
+    std::swap(_manager, that._manager);
+    std::swap(_storage, that._storage);
+  }
+
+  template<class T>
+  bool hasType() const {
+    return _manager == &Handler<T>::manager || (_manager != nullptr && _manager->type == typeid(T));
   }
 
   template<class U>
-  Derived<StorageType<U>>* getDerived(bool checkCast) const {
+  StorageType<U>* getValue() const {
     typedef StorageType<U> T;
 
-    auto derived = dynamic_cast<Derived<T>*>(_ptr);
-
-    if (checkCast && !derived)
+    if (!hasType<T>())
       throw std::bad_cast();
 
-    return derived;
+    if (Handler<T>::isInline)
+      return reinterpret_cast<T *>(const_cast<Storage *>(&_storage));
+    return static_cast<T *>(_storage.ptr);
   }
 
-  Base *_ptr;
-
 };
 
+  template<typename T>
+  const Any::Manager Any::Handler<T>::manager = {
+    typeid(T), Any::Handler<T>::isInline, &Any::Handler<T>::clone, &Any::Handler<T>::destroy
+  };
+
   template<> inline
-  Any::Any(std::nullptr_t&& ) : _ptr(nullptr) {
+  Any::Any(std::nullptr_t&& ) : _manager(nullptr) {
   }
 
 
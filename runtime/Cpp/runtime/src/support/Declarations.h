@@ -80,6 +80,7 @@ namespace antlr4 {
     class DecisionState;
     class EmptyPredictionContext;
     class EpsilonTransition;
+    class FollowSetCache;
     class LL1Analyzer;
     class LexerAction;
     class LexerActionExecutor;
@@ -124,9 +125,11 @@ namespace antlr4 {
   }
   namespace tree {
     class AbstractParseTreeVisitor;
+    template<typename T> class DenseParseTreeProperty;
     class ErrorNode;
     class ErrorNodeImpl;
     class ParseTree;
+    class ParseTreeDispatcher;
     class ParseTreeListener;
     template<typename T> class ParseTreeProperty;
     class ParseTreeVisitor;
@@ -142,6 +145,7 @@ namespace antlr4 {
       class ParseTreeMatch;
       class ParseTreePattern;
       class ParseTreePatternMatcher;
+      class ParseTreePatternSet;
       class RuleTagToken;
       class TagChunk;
       class TextChunk;
@@ -150,14 +154,8 @@ namespace antlr4 {
 
     namespace xpath {
       class XPath;
-      class XPathElement;
+      class XPathIndex;
       class XPathLexerErrorListener;
-      class XPathRuleAnywhereElement;
-      class XPathRuleElement;
-      class XPathTokenAnywhereElement;
-      class XPathTokenElement;
-      class XPathWildcardAnywhereElement;
-      class XPathWildcardElement;
     }
   }
 }
@@ -3,10 +3,555 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
+#if defined(__AVX2__)
+  #include <immintrin.h>
+  #define ANTLR4CPP_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define ANTLR4CPP_SSE2
+#endif
+
+// Multi-byte sequences are decoded with SIMD only if byte shuffles (SSSE3, part of any SSE4 or AVX2 target) are available.
+#if defined(__SSSE3__) || defined(__AVX2__)
+  #include <tmmintrin.h>
+  #define ANTLR4CPP_SSSE3
+#endif
+
 #include "support/StringUtils.h"
 
 namespace antlrcpp {
 
+namespace {
+
+  inline size_t bitCount(uint32_t value) {
+    value = value - ((value >> 1) & 0x55555555);
+    value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+    return (((value + (value >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+  }
+
+  template<typename Char>
+  inline char32_t codePoint(Char c) {
+    return static_cast<char32_t>(static_cast<typename std::make_unsigned<Char>::type>(c));
+  }
+
+  // The number of code points in [p, end), i.e. the number of bytes which are not continuation bytes.
+  size_t countCodePoints(const unsigned char *p, const unsigned char *end) {
+    size_t count = 0;
+#if defined(ANTLR4CPP_AVX2)
+    const __m256i limit = _mm256_set1_epi8(-65); // 0xBF, the largest continuation byte.
+    for (; end - p >= 32; p += 32) {
+      __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+      count += bitCount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(block, limit))));
+    }
+#elif defined(ANTLR4CPP_SSE2)
+    const __m128i limit = _mm_set1_epi8(-65);
+    for (; end - p >= 16; p += 16) {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+      count += bitCount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(block, limit))));
+    }
+#endif
+    for (; p < end; ++p) {
+      if ((*p & 0xC0) != 0x80) {
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  // Converts leading ASCII characters, as long as there are full blocks of them. Returns the number of characters converted.
+  inline size_t widenAscii(const unsigned char *p, const unsigned char *end, char32_t *out) {
+    const unsigned char *start = p;
+#if defined(ANTLR4CPP_AVX2)
+    for (; end - p >= 32; p += 32, out += 32) {
+      __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+      if (_mm256_movemask_epi8(block) != 0) {
+        break;
+      }
+      for (size_t i = 0; i < 4; ++i) {
+        __m128i part = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p + 8 * i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 8 * i), _mm256_cvtepu8_epi32(part));
+      }
+    }
+#elif defined(ANTLR4CPP_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; end - p >= 16; p += 16, out += 16) {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+      if (_mm_movemask_epi8(block) != 0) {
+        break;
+      }
+      __m128i low = _mm_unpacklo_epi8(block, zero);
+      __m128i high = _mm_unpackhi_epi8(block, zero);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi16(low, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4), _mm_unpackhi_epi16(low, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), _mm_unpacklo_epi16(high, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 12), _mm_unpackhi_epi16(high, zero));
+    }
+#else
+    for (; end - p >= 8; p += 8, out += 8) {
+      uint64_t block;
+      memcpy(&block, p, 8);
+      if ((block & 0x8080808080808080ULL) != 0) {
+        break;
+      }
+      for (size_t i = 0; i < 8; ++i) {
+        out[i] = p[i];
+      }
+    }
+#endif
+    return static_cast<size_t>(p - start);
+  }
+
+  // Generic variant for narrow targets: checks 8 bytes at a time and lets the compiler vectorize the copy.
+  template<typename Char>
+  inline size_t widenAscii(const unsigned char *p, const unsigned char *end, Char *out) {
+    const unsigned char *start = p;
+    for (; end - p >= 8; p += 8, out += 8) {
+      uint64_t block;
+      memcpy(&block, p, 8);
+      if ((block & 0x8080808080808080ULL) != 0) {
+        break;
+      }
+      for (size_t i = 0; i < 8; ++i) {
+        out[i] = static_cast<Char>(p[i]);
+      }
+    }
+    return static_cast<size_t>(p - start);
+  }
+
+#if defined(ANTLR4CPP_SSSE3)
+  // Shuffle masks which collect the 16 bit lanes selected by an 8 bit mask at the start of a vector.
+  struct CompactionTable {
+    __m128i masks[256];
+
+    CompactionTable() {
+      for (size_t selection = 0; selection < 256; ++selection) {
+        alignas(16) unsigned char bytes[16];
+        memset(bytes, 0x80, sizeof(bytes)); // Clears the lane.
+        size_t lane = 0;
+        for (unsigned char i = 0; i < 8; ++i) {
+          if ((selection & (1U << i)) != 0) {
+            bytes[2 * lane] = static_cast<unsigned char>(2 * i);
+            bytes[2 * lane + 1] = static_cast<unsigned char>(2 * i + 1);
+            ++lane;
+          }
+        }
+        masks[selection] = _mm_load_si128(reinterpret_cast<const __m128i *>(bytes));
+      }
+    }
+  };
+
+  const CompactionTable& compactionTable() {
+    static CompactionTable table;
+    return table;
+  }
+
+  // Stores the first 8 16 bit lanes of values (4 for the 3 byte path) as code units of type Char.
+  inline void storeLanes(const __m128i &values, char32_t *out) {
+    const __m128i zero = _mm_setzero_si128();
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi16(values, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4), _mm_unpackhi_epi16(values, zero));
+  }
+
+  inline void storeLanes(const __m128i &values, char16_t *out) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), values);
+  }
+
+  inline void storeLanes(const __m128i &values, char *out) {
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(values, values));
+  }
+
+  // Decodes the sequences starting in the first 8 bytes at p, if these are 1, 2 or 3 byte sequences (e.g. Latin,
+  // Cyrillic or CJK text, also mixed with ASCII). 16 bytes must be readable at p and 8 code units writable at out.
+  // Returns the number of bytes consumed and sets produced to the number of code units written, or returns 0 (without
+  // writing anything useful) if the block needs the scalar path, which also reports errors.
+  template<typename Char>
+  inline size_t decodeBlock(const unsigned char *p, Char *out, size_t &produced, char32_t maxCodePoint) {
+    const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+    // Bit i is set if byte i is a continuation byte (10xxxxxx) or is >= the given lead byte respectively.
+    const __m128i high = _mm_and_si128(input, _mm_set1_epi8(static_cast<char>(0xC0)));
+    unsigned continuations = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(high, _mm_set1_epi8(static_cast<char>(0x80)))));
+    unsigned from2 = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(input, _mm_set1_epi8(static_cast<char>(0xC0))), input)));
+    unsigned from3 = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(input, _mm_set1_epi8(static_cast<char>(0xE0))), input)));
+    unsigned from4 = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(input, _mm_set1_epi8(static_cast<char>(0xF0))), input)));
+    unsigned leads2 = from2 & ~from3 & 0xFF;
+    unsigned leads3 = from3 & ~from4 & 0xFF;
+
+    // Consume 8 bytes plus the rest of a sequence which starts in them.
+    size_t length = 8 + ((leads2 >> 7) & 1) + ((leads3 >> 6) & 1) + ((leads3 >> 7) & 1) * 2;
+    unsigned range = (1U << length) - 1;
+    if ((from4 & range) != 0) {
+      return 0;
+    }
+    unsigned expected = (leads2 << 1) | (leads3 << 1) | (leads3 << 2);
+    if ((expected & range) != (continuations & range)) {
+      return 0; // A lead without continuation or vice versa.
+    }
+
+    // Overlong 2 byte forms (leads 0xC0 and 0xC1).
+    const __m128i overlong = _mm_cmpeq_epi8(_mm_and_si128(input, _mm_set1_epi8(static_cast<char>(0xFE))),
+                                            _mm_set1_epi8(static_cast<char>(0xC0)));
+    if ((_mm_movemask_epi8(overlong) & range) != 0) {
+      return 0;
+    }
+
+    // Decode at every position as if it was the start of a sequence, then drop the continuation positions.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i current = _mm_unpacklo_epi8(input, zero);
+    const __m128i next = _mm_and_si128(_mm_unpacklo_epi8(_mm_srli_si128(input, 1), zero), _mm_set1_epi16(0x3F));
+    const __m128i afterNext = _mm_and_si128(_mm_unpacklo_epi8(_mm_srli_si128(input, 2), zero), _mm_set1_epi16(0x3F));
+    const __m128i twoByte = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(current, _mm_set1_epi16(0x1F)), 6), next);
+    const __m128i threeByte = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_and_si128(current, _mm_set1_epi16(0x0F)), 12),
+                                                        _mm_slli_epi16(next, 6)), afterNext);
+    const __m128i isLead = _mm_cmpgt_epi16(current, _mm_set1_epi16(0xBF));
+    const __m128i isLead3 = _mm_cmpgt_epi16(current, _mm_set1_epi16(0xDF));
+    __m128i values = _mm_or_si128(_mm_and_si128(isLead, twoByte), _mm_andnot_si128(isLead, current));
+    values = _mm_or_si128(_mm_and_si128(isLead3, threeByte), _mm_andnot_si128(isLead3, values));
+
+    // Overlong 3 byte forms (below U+0800) and surrogates.
+    const __m128i plane = _mm_and_si128(values, _mm_set1_epi16(static_cast<short>(0xF800)));
+    const __m128i invalid = _mm_and_si128(isLead3, _mm_or_si128(_mm_cmpeq_epi16(plane, zero),
+      _mm_cmpeq_epi16(plane, _mm_set1_epi16(static_cast<short>(0xD800)))));
+    if (_mm_movemask_epi8(invalid) != 0) {
+      return 0;
+    }
+
+    unsigned starts = ~continuations & 0xFF;
+    values = _mm_shuffle_epi8(values, compactionTable().masks[starts]);
+    produced = bitCount(starts);
+
+    if (maxCodePoint < 0xFFFF) {
+      const __m128i excess = _mm_subs_epu16(values, _mm_set1_epi16(static_cast<short>(maxCodePoint)));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(excess, zero)) != 0xFFFF) {
+        return 0;
+      }
+    }
+
+    storeLanes(values, out);
+    return length;
+  }
+
+  // Decodes 4 consecutive 3 byte sequences at p, which is faster than decodeBlock for pure CJK text. The same
+  // requirements and results as for decodeBlock apply.
+  template<typename Char>
+  inline size_t decodeThreeByteBlock(const unsigned char *p, Char *out, size_t &produced, char32_t maxCodePoint) {
+    if (maxCodePoint < 0xFFFF) {
+      return 0;
+    }
+
+    const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    const __m128i high = _mm_and_si128(input, _mm_set1_epi8(static_cast<char>(0xC0)));
+    unsigned continuations = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(high, _mm_set1_epi8(static_cast<char>(0x80)))));
+    const __m128i leadBits = _mm_and_si128(input, _mm_set1_epi8(static_cast<char>(0xF0)));
+    unsigned leads = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(leadBits, _mm_set1_epi8(static_cast<char>(0xE0)))));
+    if ((continuations & 0xFFF) != 0xDB6 || (leads & 0xFFF) != 0x249) {
+      return 0;
+    }
+
+    // Collect the first, second and third byte of each sequence in 16 bit lanes.
+    const __m128i first = _mm_shuffle_epi8(input, _mm_setr_epi8(0, -128, 3, -128, 6, -128, 9, -128, -128, -128, -128, -128, -128, -128, -128, -128));
+    const __m128i second = _mm_shuffle_epi8(input, _mm_setr_epi8(1, -128, 4, -128, 7, -128, 10, -128, -128, -128, -128, -128, -128, -128, -128, -128));
+    const __m128i third = _mm_shuffle_epi8(input, _mm_setr_epi8(2, -128, 5, -128, 8, -128, 11, -128, -128, -128, -128, -128, -128, -128, -128, -128));
+    const __m128i values = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_and_si128(first, _mm_set1_epi16(0x0F)), 12),
+                                                     _mm_slli_epi16(_mm_and_si128(second, _mm_set1_epi16(0x3F)), 6)),
+                                        _mm_and_si128(third, _mm_set1_epi16(0x3F)));
+
+    // Overlong forms (below U+0800) and surrogates.
+    const __m128i range = _mm_and_si128(values, _mm_set1_epi16(static_cast<short>(0xF800)));
+    const __m128i invalid = _mm_or_si128(_mm_cmpeq_epi16(range, _mm_setzero_si128()),
+                                         _mm_cmpeq_epi16(range, _mm_set1_epi16(static_cast<short>(0xD800))));
+    if ((_mm_movemask_epi8(invalid) & 0xFF) != 0) {
+      return 0;
+    }
+
+    storeLanes(values, out);
+    produced = 4;
+    return 12;
+  }
+#endif
+
+  template<typename Char>
+  inline size_t narrowAscii(const Char *p, const Char *end, char *out) {
+    const Char *start = p;
+    for (; p < end && codePoint(*p) < 0x80; ++p, ++out) {
+      *out = static_cast<char>(*p);
+    }
+    return static_cast<size_t>(p - start);
+  }
+
+  // Converts leading ASCII code points, as long as there are full blocks of them. Returns the number of code points converted.
+  inline size_t narrowAscii(const char32_t *p, const char32_t *end, char *out) {
+    const char32_t *start = p;
+#if defined(ANTLR4CPP_AVX2)
+    const __m256i mask = _mm256_set1_epi32(~0x7F);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    for (; end - p >= 32; p += 32, out += 32) {
+      const __m256i *source = reinterpret_cast<const __m256i *>(p);
+      __m256i a = _mm256_loadu_si256(source);
+      __m256i b = _mm256_loadu_si256(source + 1);
+      __m256i c = _mm256_loadu_si256(source + 2);
+      __m256i d = _mm256_loadu_si256(source + 3);
+      __m256i all = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+      if (!_mm256_testz_si256(all, mask)) {
+        break;
+      }
+      // Packing works per 128 bit lane, so the result needs a final permutation.
+      __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_permutevar8x32_epi32(packed, order));
+    }
+#elif defined(ANTLR4CPP_SSE2)
+    const __m128i mask = _mm_set1_epi32(~0x7F);
+    const __m128i zero = _mm_setzero_si128();
+    for (; end - p >= 16; p += 16, out += 16) {
+      const __m128i *source = reinterpret_cast<const __m128i *>(p);
+      __m128i a = _mm_loadu_si128(source);
+      __m128i b = _mm_loadu_si128(source + 1);
+      __m128i c = _mm_loadu_si128(source + 2);
+      __m128i d = _mm_loadu_si128(source + 3);
+      __m128i all = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), mask);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(all, zero)) != 0xFFFF) {
+        break;
+      }
+      __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out), packed);
+    }
+#else
+    for (; p < end && *p < 0x80; ++p, ++out) {
+      *out = static_cast<char>(*p);
+    }
+#endif
+    return static_cast<size_t>(p - start);
+  }
+
+  // Decodes the sequence at p and advances p. Returns false (without advancing) if the sequence is not well formed.
+  inline bool decodeSequence(const unsigned char *&p, const unsigned char *end, char32_t &result) {
+    unsigned char c = p[0];
+    size_t available = static_cast<size_t>(end - p);
+    if (c < 0x80) {
+      result = c;
+      ++p;
+      return true;
+    }
+
+    if (c < 0xC2) {
+      return false; // Continuation byte or overlong 2 byte form.
+    }
+
+    if (c < 0xE0) {
+      if (available < 2 || (p[1] & 0xC0) != 0x80) {
+        return false;
+      }
+      result = ((c & 0x1Fu) << 6) | (p[1] & 0x3Fu);
+      p += 2;
+      return true;
+    }
+
+    if (c < 0xF0) {
+      if (available < 3 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80) {
+        return false;
+      }
+      if ((c == 0xE0 && p[1] < 0xA0) || (c == 0xED && p[1] > 0x9F)) {
+        return false; // Overlong or surrogate.
+      }
+      result = ((c & 0x0Fu) << 12) | ((p[1] & 0x3Fu) << 6) | (p[2] & 0x3Fu);
+      p += 3;
+      return true;
+    }
+
+    if (c < 0xF5) {
+      if (available < 4 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80) {
+        return false;
+      }
+      if ((c == 0xF0 && p[1] < 0x90) || (c == 0xF4 && p[1] > 0x8F)) {
+        return false; // Overlong or beyond U+10FFFF.
+      }
+      result = ((c & 0x07u) << 18) | ((p[1] & 0x3Fu) << 12) | ((p[2] & 0x3Fu) << 6) | (p[3] & 0x3Fu);
+      p += 4;
+      return true;
+    }
+
+    return false;
+  }
+
+  // Returns the number of UTF-8 bytes needed for c, or 0 if c is no valid code point.
+  inline size_t encodedLength(char32_t c) {
+    if (c < 0x80)
+      return 1;
+    if (c < 0x800)
+      return 2;
+    if (c < 0x10000)
+      return (c >= 0xD800 && c <= 0xDFFF) ? 0 : 3;
+    return (c <= 0x10FFFF) ? 4 : 0;
+  }
+
+  // Decodes UTF-8 into code units of type Char. Code points beyond maxCodePoint are treated as errors.
+  template<typename Char, typename String>
+  bool decodeUtf8(const char *first, const char *last, String &result, size_t &errorOffset, char32_t maxCodePoint) {
+    const unsigned char *start = reinterpret_cast<const unsigned char *>(first);
+    const unsigned char *end = reinterpret_cast<const unsigned char *>(last);
+
+    // The count is exact for valid input and an upper bound for what can be decoded otherwise.
+    result.resize(countCodePoints(start, end));
+    if (start == end) {
+      return true;
+    }
+
+    Char *out = reinterpret_cast<Char *>(&result[0]);
+    Char *outStart = out;
+#if defined(ANTLR4CPP_SSSE3)
+    Char *outEnd = outStart + result.size();
+#endif
+    const unsigned char *p = start;
+    while (p < end) {
+      size_t count = widenAscii(p, end, out);
+      p += count;
+      out += count;
+
+      // Mixed content: continue without the ASCII path for at least one block (so we don't retry it on every
+      // character) and as long as there are non-ASCII characters.
+      for (size_t i = 0; p < end && (i < 16 || *p >= 0x80); ++i) {
+#if defined(ANTLR4CPP_SSSE3)
+        if (end - p >= 16 && outEnd - out >= 8) {
+          size_t produced = 0;
+          size_t consumed = *p >= 0xE0 ? decodeThreeByteBlock(p, out, produced, maxCodePoint) : 0;
+          if (consumed == 0) {
+            consumed = decodeBlock(p, out, produced, maxCodePoint);
+          }
+          if (consumed > 0) {
+            p += consumed;
+            out += produced;
+            continue;
+          }
+        }
+#endif
+
+        const unsigned char *sequence = p;
+        char32_t c;
+        if (!decodeSequence(p, end, c) || c > maxCodePoint) {
+          errorOffset = static_cast<size_t>(sequence - start);
+          result.resize(static_cast<size_t>(out - outStart));
+          return false;
+        }
+        *out++ = static_cast<Char>(c);
+      }
+    }
+
+    return true;
+  }
+
+  template<typename Char>
+  bool encodeUtf8(const Char *first, const Char *last, std::string &result, size_t &errorOffset) {
+    // First pass: determine the size of the result and validate.
+    size_t length = 0;
+    const Char *p = first;
+    for (; p < last; ++p) {
+      size_t n = encodedLength(codePoint(*p));
+      if (n == 0) {
+        break;
+      }
+      length += n;
+    }
+
+    const Char *end = p;
+    result.resize(length);
+    if (length > 0) {
+      char *out = &result[0];
+      p = first;
+      while (p < end) {
+        size_t count = narrowAscii(p, end, out);
+        p += count;
+        out += count;
+
+        // See decodeUtf8 for the scalar run length.
+        for (size_t i = 0; p < end && (i < 16 || codePoint(*p) >= 0x80); ++i, ++p) {
+          char32_t c = codePoint(*p);
+          if (c < 0x80) {
+            *out++ = static_cast<char>(c);
+            continue;
+          }
+
+          if (c < 0x800) {
+            *out++ = static_cast<char>(0xC0 | (c >> 6));
+          } else if (c < 0x10000) {
+            *out++ = static_cast<char>(0xE0 | (c >> 12));
+            *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+          } else {
+            *out++ = static_cast<char>(0xF0 | (c >> 18));
+            *out++ = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+          }
+          *out++ = static_cast<char>(0x80 | (c & 0x3F));
+        }
+      }
+    }
+
+    if (end != last) {
+      errorOffset = static_cast<size_t>(end - first);
+      return false;
+    }
+    return true;
+  }
+
+  void throwDecodingError(size_t errorOffset) {
+    throw std::range_error("invalid UTF-8 sequence at byte offset " + std::to_string(errorOffset));
+  }
+
+  void throwEncodingError(size_t errorOffset) {
+    throw std::range_error("invalid code point at index " + std::to_string(errorOffset));
+  }
+
+}
+
+bool utf8_to_utf32(const char *first, const char *last, UTF32String &result, size_t &errorOffset) {
+  return decodeUtf8<char32_t>(first, last, result, errorOffset, 0x10FFFF);
+}
+
+UTF32String utf8_to_utf32(const char *first, const char *last) {
+  UTF32String result;
+  size_t errorOffset;
+  if (!utf8_to_utf32(first, last, result, errorOffset)) {
+    throwDecodingError(errorOffset);
+  }
+  return result;
+}
+
+bool utf8_to_ucs2(const char *first, const char *last, std::u16string &result, size_t &errorOffset) {
+  return decodeUtf8<char16_t>(first, last, result, errorOffset, 0xFFFF);
+}
+
+bool utf8_to_latin1(const char *first, const char *last, std::string &result, size_t &errorOffset) {
+  return decodeUtf8<char>(first, last, result, errorOffset, 0xFF);
+}
+
+bool utf32_to_utf8(const char32_t *first, const char32_t *last, std::string &result, size_t &errorOffset) {
+  return encodeUtf8(first, last, result, errorOffset);
+}
+
+std::string utf32_to_utf8(const char32_t *first, const char32_t *last) {
+  std::string result;
+  size_t errorOffset;
+  if (!utf32_to_utf8(first, last, result, errorOffset)) {
+    throwEncodingError(errorOffset);
+  }
+  return result;
+}
+
+std::string ucs2_to_utf8(const char16_t *first, const char16_t *last) {
+  std::string result;
+  size_t errorOffset;
+  if (!encodeUtf8(first, last, result, errorOffset)) {
+    throwEncodingError(errorOffset);
+  }
+  return result;
+}
+
+std::string latin1_to_utf8(const char *first, const char *last) {
+  std::string result;
+  size_t errorOffset;
+  encodeUtf8(first, last, result, errorOffset); // Cannot fail.
+  return result;
+}
+
 void replaceAll(std::string& str, std::string const& from, std::string const& to)
 {
   if (from.empty())
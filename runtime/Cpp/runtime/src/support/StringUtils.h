@@ -9,41 +9,40 @@
 
 namespace antlrcpp {
 
-  // For all conversions utf8 <-> utf32.
-  // VS 2015 and VS 2017 have different bugs in std::codecvt_utf8<char32_t> (VS 2013 works fine).
-#if defined(_MSC_VER) && _MSC_VER >= 1900 && _MSC_VER < 2000
-  typedef std::wstring_convert<std::codecvt_utf8<__int32>, __int32> UTF32Converter;
-#else
-  typedef std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> UTF32Converter;
-#endif
-  
-  // The conversion functions fails in VS2017, so we explicitly use a workaround.
+  // Conversions utf8 <-> utf32. Decoding uses SIMD instructions for runs of ASCII characters (SSE2 or, if enabled
+  // at compile time, AVX2) and, if SSSE3 is enabled at compile time, also for blocks of mixed 1, 2 and 3 byte
+  // sequences. 4 byte sequences, invalid input and encoding use scalar loops. Input is strictly validated: overlong
+  // forms, surrogates and values beyond U+10FFFF are rejected.
+
+  // Converts the UTF-8 input [first, last) to UTF-32. If the input is not well formed, false is returned and errorOffset
+  // is set to the byte offset of the first invalid sequence. result then contains all characters before that sequence.
+  ANTLR4CPP_PUBLIC bool utf8_to_utf32(const char *first, const char *last, UTF32String &result, size_t &errorOffset);
+
+  // Same as above, but throws std::range_error for invalid input.
+  ANTLR4CPP_PUBLIC UTF32String utf8_to_utf32(const char *first, const char *last);
+
+  // Narrow variants of utf8_to_utf32, which store code points up to U+FFFF (UCS-2) or U+00FF (Latin-1) respectively.
+  // These fail like utf8_to_utf32 but also if a code point does not fit into the target width.
+  ANTLR4CPP_PUBLIC bool utf8_to_ucs2(const char *first, const char *last, std::u16string &result, size_t &errorOffset);
+  ANTLR4CPP_PUBLIC bool utf8_to_latin1(const char *first, const char *last, std::string &result, size_t &errorOffset);
+
+  // Converts the UTF-32 input [first, last) to UTF-8. If a value is not a valid code point (surrogate or beyond U+10FFFF),
+  // false is returned and errorOffset is set to its index. result then contains all characters before that value.
+  ANTLR4CPP_PUBLIC bool utf32_to_utf8(const char32_t *first, const char32_t *last, std::string &result, size_t &errorOffset);
+
+  // Same as above, but throws std::range_error for invalid input.
+  ANTLR4CPP_PUBLIC std::string utf32_to_utf8(const char32_t *first, const char32_t *last);
+
+  // Counterparts of utf8_to_ucs2 and utf8_to_latin1. Throws std::range_error for surrogates in UCS-2 input.
+  ANTLR4CPP_PUBLIC std::string ucs2_to_utf8(const char16_t *first, const char16_t *last);
+  ANTLR4CPP_PUBLIC std::string latin1_to_utf8(const char *first, const char *last);
+
   template<typename T>
   inline std::string utf32_to_utf8(T const& data)
   {
-    // Don't make the converter static or we have to serialize access to it.
-    UTF32Converter converter;
-
-    #if defined(_MSC_VER) && _MSC_VER >= 1900 && _MSC_VER < 2000
-      auto p = reinterpret_cast<const int32_t *>(data.data());
-      return converter.to_bytes(p, p + data.size());
-    #else
-      return converter.to_bytes(data);
-    #endif
-  }
-
-  inline UTF32String utf8_to_utf32(const char* first, const char* last)
-  {
-    UTF32Converter converter;
-
-    #if defined(_MSC_VER) && _MSC_VER >= 1900 && _MSC_VER < 2000
-      auto r = converter.from_bytes(first, last);
-      i32string s = reinterpret_cast<const int32_t *>(r.data());
-    #else
-      std::u32string s = converter.from_bytes(first, last);
-    #endif
-    
-    return s;
+    // Works for i32string (VS 2015/2017) too, which has the same element size.
+    auto p = reinterpret_cast<const char32_t *>(data.data());
+    return utf32_to_utf8(p, p + data.size());
   }
 
   void replaceAll(std::string &str, std::string const& from, std::string const& to);
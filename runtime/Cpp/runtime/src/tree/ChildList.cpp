@@ -0,0 +1,103 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "Exceptions.h"
+
+#include "tree/ChildList.h"
+
+using namespace antlr4;
+using namespace antlr4::tree;
+
+ChildList::~ChildList() {
+  ::operator delete(_header);
+}
+
+ChildList& ChildList::operator = (std::initializer_list<ParseTree *> list) {
+  clear();
+  reserve(list.size());
+  for (auto child : list) {
+    push_back(child);
+  }
+  return *this;
+}
+
+ChildList::reference ChildList::at(size_t index) {
+  if (index >= size()) {
+    throw IndexOutOfBoundsException();
+  }
+  return elements()[index];
+}
+
+ChildList::const_reference ChildList::at(size_t index) const {
+  if (index >= size()) {
+    throw IndexOutOfBoundsException();
+  }
+  return elements()[index];
+}
+
+ChildList::iterator ChildList::insert(const_iterator position, ParseTree *child) {
+  size_t index = static_cast<size_t>(position - begin());
+  push_back(child);
+
+  ParseTree **first = elements();
+  std::rotate(first + index, first + _header->size - 1, first + _header->size);
+  return first + index;
+}
+
+ChildList::iterator ChildList::erase(const_iterator position) {
+  return erase(position, position + 1);
+}
+
+ChildList::iterator ChildList::erase(const_iterator first, const_iterator last) {
+  if (first == last) {
+    return begin() + (first - begin());
+  }
+
+  ParseTree **start = begin() + (first - begin());
+  ParseTree **stop = begin() + (last - begin());
+  std::move(stop, end(), start);
+  _header->size -= static_cast<uint32_t>(stop - start);
+  return start;
+}
+
+void ChildList::reserve(size_t newCapacity) {
+  if (newCapacity > capacity()) {
+    reallocate(newCapacity);
+  }
+}
+
+void ChildList::shrink_to_fit() {
+  if (_header == nullptr) {
+    return;
+  }
+
+  if (_header->size == 0) {
+    ::operator delete(_header);
+    _header = nullptr;
+  } else if (_header->size < _header->capacity) {
+    reallocate(_header->size);
+  }
+}
+
+void ChildList::reallocate(size_t newCapacity) {
+  if (newCapacity > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("too many children in a parse tree node");
+  }
+
+  size_t count = size();
+  Header *header = static_cast<Header *>(::operator new(sizeof(Header) + newCapacity * sizeof(ParseTree *)));
+  header->size = static_cast<uint32_t>(count);
+  header->capacity = static_cast<uint32_t>(newCapacity);
+  if (count > 0) {
+    memcpy(reinterpret_cast<char *>(header) + sizeof(Header), elements(), count * sizeof(ParseTree *));
+  }
+
+  ::operator delete(_header);
+  _header = header;
+}
+
+void ChildList::grow(size_t minCapacity) {
+  reallocate(std::max(minCapacity, std::max<size_t>(capacity() * 2, 2)));
+}
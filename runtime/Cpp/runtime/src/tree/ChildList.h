@@ -0,0 +1,130 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace tree {
+
+  /// The list of children of a parse tree node. It offers the commonly used part of the std::vector
+  /// interface, but occupies only a single pointer in the node: size, capacity and elements are kept
+  /// together in one memory block, which doesn't exist at all for an empty list (e.g. for all terminal
+  /// nodes).
+  class ANTLR4CPP_PUBLIC ChildList {
+  public:
+    typedef ParseTree* value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef ParseTree*& reference;
+    typedef ParseTree* const& const_reference;
+    typedef ParseTree** pointer;
+    typedef ParseTree* const* const_pointer;
+    typedef ParseTree** iterator;
+    typedef ParseTree* const* const_iterator;
+
+    struct Header {
+      uint32_t size;
+      uint32_t capacity;
+    };
+
+    ChildList() : _header(nullptr) {}
+    ChildList(ChildList const&) = delete;
+    ~ChildList();
+
+    ChildList& operator = (ChildList const&) = delete;
+    ChildList& operator = (std::initializer_list<ParseTree *> list);
+
+    /// Copies the children into a std::vector, for code which needs one.
+    operator std::vector<ParseTree *>() const {
+      return std::vector<ParseTree *>(begin(), end());
+    }
+
+    size_t size() const {
+      return _header == nullptr ? 0 : _header->size;
+    }
+
+    bool empty() const {
+      return size() == 0;
+    }
+
+    size_t capacity() const {
+      return _header == nullptr ? 0 : _header->capacity;
+    }
+
+    ParseTree** data() {
+      return _header == nullptr ? nullptr : elements();
+    }
+
+    ParseTree* const* data() const {
+      return _header == nullptr ? nullptr : elements();
+    }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size(); }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    reference operator [] (size_t index) {
+      return elements()[index];
+    }
+
+    const_reference operator [] (size_t index) const {
+      return elements()[index];
+    }
+
+    /// Same as operator [], but throws an IndexOutOfBoundsException for an invalid index.
+    reference at(size_t index);
+    const_reference at(size_t index) const;
+
+    reference front() { return elements()[0]; }
+    const_reference front() const { return elements()[0]; }
+    reference back() { return elements()[_header->size - 1]; }
+    const_reference back() const { return elements()[_header->size - 1]; }
+
+    void push_back(ParseTree *child) {
+      if (size() == capacity()) {
+        grow(size() + 1);
+      }
+      elements()[_header->size++] = child;
+    }
+
+    void pop_back() {
+      --_header->size;
+    }
+
+    void clear() {
+      if (_header != nullptr) {
+        _header->size = 0;
+      }
+    }
+
+    iterator insert(const_iterator position, ParseTree *child);
+    iterator erase(const_iterator position);
+    iterator erase(const_iterator first, const_iterator last);
+
+    void reserve(size_t newCapacity);
+
+    /// Releases unused memory of the block.
+    void shrink_to_fit();
+
+  private:
+    Header *_header;
+
+    ParseTree** elements() const {
+      return reinterpret_cast<ParseTree **>(reinterpret_cast<char *>(_header) + sizeof(Header));
+    }
+
+    /// Moves the children into a new block with the given capacity.
+    void reallocate(size_t newCapacity);
+
+    void grow(size_t minCapacity);
+  };
+
+} // namespace tree
+} // namespace antlr4
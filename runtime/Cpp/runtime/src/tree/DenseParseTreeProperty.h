@@ -0,0 +1,77 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "tree/ParseTree.h"
+#include "tree/ParseTreeProperty.h"
+
+namespace antlr4 {
+namespace tree {
+
+  /// A ParseTreeProperty which stores the values in a vector indexed by the ordinal of the node
+  /// (see ParseTree::getOrdinal()), instead of a map. Lookups don't need to search and no memory is
+  /// allocated per node, which makes it the better choice when most nodes of a tree get a value.
+  /// Nodes without an ordinal are kept in the map of the base class.
+  ///
+  /// The ordinals of different trackers overlap, so all nodes must come from the same parser (or
+  /// ParseTreeTracker). Like in the base class, get() returns a default constructed value for nodes
+  /// without a value.
+  template<typename V>
+  class ANTLR4CPP_PUBLIC DenseParseTreeProperty : public ParseTreeProperty<V> {
+  public:
+    /// Pass the node count of the tree, e.g. parser.getTreeTracker().getOrdinalCount(), to allocate
+    /// the storage for all nodes at once.
+    DenseParseTreeProperty(size_t nodeCount = 0) {
+      _values.reserve(nodeCount);
+    }
+
+    virtual V get(ParseTree *node) override {
+      size_t ordinal = node->getOrdinal();
+      if (ordinal == INVALID_INDEX) {
+        return ParseTreeProperty<V>::get(node);
+      }
+      return ordinal < _values.size() ? _values[ordinal] : V();
+    }
+
+    virtual void put(ParseTree *node, V value) override {
+      size_t ordinal = node->getOrdinal();
+      if (ordinal == INVALID_INDEX) {
+        ParseTreeProperty<V>::put(node, std::move(value));
+        return;
+      }
+
+      if (ordinal >= _values.size()) {
+        _values.resize(ordinal + 1);
+      }
+      _values[ordinal] = std::move(value);
+    }
+
+    virtual V removeFrom(ParseTree *node) override {
+      size_t ordinal = node->getOrdinal();
+      if (ordinal == INVALID_INDEX) {
+        return ParseTreeProperty<V>::removeFrom(node);
+      }
+
+      if (ordinal >= _values.size()) {
+        return V();
+      }
+      V value = std::move(_values[ordinal]);
+      _values[ordinal] = V();
+      return value;
+    }
+
+    /// Removes all values.
+    void clear() {
+      _values.clear();
+      this->_annotations.clear();
+    }
+
+  protected:
+    std::vector<V> _values; // Indexed by node ordinal.
+  };
+
+} // namespace tree
+} // namespace antlr4
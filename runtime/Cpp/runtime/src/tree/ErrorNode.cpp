@@ -5,5 +5,10 @@
 
 #include "tree/ErrorNode.h"
 
+antlr4::tree::ErrorNode::ErrorNode() {
+  // TerminalNode is a virtual base, so it's always constructed with the TERMINAL type.
+  setTreeType(ParseTreeType::ERROR);
+}
+
 antlr4::tree::ErrorNode::~ErrorNode() {
 }
@@ -0,0 +1,281 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include <thread>
+
+#include "tree/ParseTree.h"
+#include "tree/ParseTreeListener.h"
+#include "tree/ParseTreeWalker.h"
+
+#include "tree/ParallelParseTreeWalker.h"
+
+using namespace antlr4;
+using namespace antlr4::tree;
+
+namespace {
+
+  struct Task {
+    size_t start; // Index of the first subtree.
+    size_t stop; // Index after the last subtree.
+    std::unique_ptr<ParseTreeListener> listener;
+    std::exception_ptr error;
+  };
+
+  /// The task queue of one worker. Its owner takes tasks from the front, other workers steal from the back,
+  /// so that owner and thieves rarely want the same task.
+  struct WorkQueue {
+    std::mutex lock;
+    std::deque<size_t> tasks;
+
+    bool popFront(size_t &task) {
+      std::lock_guard<std::mutex> guard(lock);
+      if (tasks.empty()) {
+        return false;
+      }
+      task = tasks.front();
+      tasks.pop_front();
+      return true;
+    }
+
+    bool popBack(size_t &task) {
+      std::lock_guard<std::mutex> guard(lock);
+      if (tasks.empty()) {
+        return false;
+      }
+      task = tasks.back();
+      tasks.pop_back();
+      return true;
+    }
+  };
+
+  class WalkState {
+  public:
+    WalkState(ParseTree *root, const ParallelParseTreeWalker::ListenerFactory &createListener, size_t taskCount,
+              size_t granularity, size_t workerCount)
+      : _root(root), _createListener(createListener), _tasks(taskCount), _queues(workerCount), _failed(false) {
+      size_t subtreeCount = root->children.size();
+      for (size_t i = 0; i < taskCount; ++i) {
+        _tasks[i].start = i * granularity;
+        _tasks[i].stop = std::min(subtreeCount, (i + 1) * granularity);
+      }
+
+      // Consecutive tasks go to the same worker, which gives every worker a contiguous part of the tree
+      // to start with.
+      for (size_t i = 0; i < workerCount; ++i) {
+        for (size_t task = taskCount * i / workerCount; task < taskCount * (i + 1) / workerCount; ++task) {
+          _queues[i].tasks.push_back(task);
+        }
+      }
+    }
+
+    std::vector<Task>& getTasks() {
+      return _tasks;
+    }
+
+    void work(size_t worker) {
+      size_t task;
+      while (nextTask(worker, task)) {
+        run(_tasks[task]);
+      }
+    }
+
+  private:
+    ParseTree *_root;
+    const ParallelParseTreeWalker::ListenerFactory &_createListener;
+    std::vector<Task> _tasks;
+    std::vector<WorkQueue> _queues;
+    std::atomic<bool> _failed;
+
+    bool nextTask(size_t worker, size_t &task) {
+      if (_queues[worker].popFront(task)) {
+        return true;
+      }
+
+      // Nothing left in the own queue, so try to steal from the others. A queue never gets new tasks,
+      // so one pass over all of them is enough to find out that there's no work left.
+      for (size_t i = 1; i < _queues.size(); ++i) {
+        if (_queues[(worker + i) % _queues.size()].popBack(task)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void run(Task &task) {
+      if (_failed) {
+        return;
+      }
+
+      try {
+        task.listener = _createListener();
+        for (size_t i = task.start; i < task.stop; ++i) {
+          ParseTreeWalker::DEFAULT.walk(task.listener.get(), _root->children[i]);
+        }
+      } catch (...) {
+        task.error = std::current_exception();
+        _failed = true;
+      }
+    }
+  };
+
+}
+
+//------------------ WorkerPool ----------------------------------------------------------------------------------------
+
+struct ParallelParseTreeWalker::WorkerPool::State {
+  std::mutex lock; // Guards all fields below, except for threads and running.
+  std::condition_variable jobStarted;
+  std::condition_variable jobDone;
+  const Job *job = nullptr;
+  size_t workerCount = 0; // The workers of the current job.
+  size_t generation = 0; // Incremented for each job.
+  size_t pending = 0; // The pool threads which haven't finished the current job yet.
+  bool stop = false;
+
+  std::vector<std::thread> threads;
+  std::mutex running; // Held by run() while the threads work on its job.
+
+  void work(size_t worker) {
+    size_t seen = 0;
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+      jobStarted.wait(guard, [&] { return stop || generation != seen; });
+      if (stop) {
+        return;
+      }
+
+      seen = generation;
+      if (worker >= workerCount) {
+        continue;
+      }
+
+      const Job *current = job;
+      guard.unlock();
+      (*current)(worker);
+      guard.lock();
+      if (--pending == 0) {
+        jobDone.notify_one();
+      }
+    }
+  }
+};
+
+ParallelParseTreeWalker::WorkerPool::WorkerPool(size_t threadCount) : _state(new State()) {
+  if (threadCount == 0) {
+    threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }
+
+  _state->threads.reserve(threadCount - 1);
+  try {
+    for (size_t i = 1; i < threadCount; ++i) {
+      _state->threads.emplace_back(&State::work, _state.get(), i);
+    }
+  } catch (...) {
+    // Couldn't start all threads, so the pool works with those which are running.
+  }
+}
+
+ParallelParseTreeWalker::WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> guard(_state->lock);
+    _state->stop = true;
+  }
+  _state->jobStarted.notify_all();
+  for (auto &thread : _state->threads) {
+    thread.join();
+  }
+}
+
+size_t ParallelParseTreeWalker::WorkerPool::getThreadCount() const {
+  return _state->threads.size() + 1;
+}
+
+size_t ParallelParseTreeWalker::WorkerPool::run(size_t workerCount, const Job &job) {
+  workerCount = std::min(workerCount, getThreadCount());
+  std::unique_lock<std::mutex> running(_state->running, std::defer_lock);
+  if (workerCount <= 1 || !running.try_lock()) {
+    job(0);
+    return 1;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(_state->lock);
+    _state->job = &job;
+    _state->workerCount = workerCount;
+    _state->pending = workerCount - 1;
+    ++_state->generation;
+  }
+  _state->jobStarted.notify_all();
+
+  job(0);
+
+  std::unique_lock<std::mutex> guard(_state->lock);
+  _state->jobDone.wait(guard, [this] { return _state->pending == 0; });
+  _state->job = nullptr;
+  return workerCount;
+}
+
+//------------------ ParallelParseTreeWalker ---------------------------------------------------------------------------
+
+ParallelParseTreeWalker::ParallelParseTreeWalker(size_t threadCount)
+  : ParallelParseTreeWalker(std::make_shared<WorkerPool>(threadCount)) {
+}
+
+ParallelParseTreeWalker::ParallelParseTreeWalker(Ref<WorkerPool> pool) : _pool(std::move(pool)), _granularity(0) {
+}
+
+ParallelParseTreeWalker::~ParallelParseTreeWalker() {
+}
+
+size_t ParallelParseTreeWalker::getThreadCount() const {
+  return _pool->getThreadCount();
+}
+
+Ref<ParallelParseTreeWalker::WorkerPool> ParallelParseTreeWalker::getWorkerPool() const {
+  return _pool;
+}
+
+void ParallelParseTreeWalker::setGranularity(size_t subtreesPerTask) {
+  _granularity = subtreesPerTask;
+}
+
+size_t ParallelParseTreeWalker::getGranularity() const {
+  return _granularity;
+}
+
+void ParallelParseTreeWalker::walk(ParseTree *t, const ListenerFactory &createListener,
+                                   const MergeFunction &merge) const {
+  size_t subtreeCount = t->children.size();
+  if (subtreeCount == 0) {
+    return;
+  }
+
+  size_t granularity = _granularity;
+  size_t threadCount = _pool->getThreadCount();
+  if (granularity == 0) {
+    granularity = std::max<size_t>(subtreeCount / (threadCount * 8), 1);
+  }
+  size_t taskCount = (subtreeCount + granularity - 1) / granularity;
+  size_t workerCount = std::min(threadCount, taskCount);
+
+  WalkState state(t, createListener, taskCount, granularity, workerCount);
+
+  // If the pool runs fewer workers (e.g. because it is busy with another walk), the running workers steal
+  // the tasks of the missing ones.
+  _pool->run(workerCount, [&state](size_t worker) {
+    state.work(worker);
+  });
+
+  std::vector<Task> &tasks = state.getTasks();
+  for (auto &task : tasks) {
+    if (task.error) {
+      std::rethrow_exception(task.error);
+    }
+  }
+
+  for (auto &task : tasks) {
+    merge(task.listener.get());
+  }
+}
@@ -0,0 +1,92 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace tree {
+
+  class ParseTreeListener;
+
+  /// Walks the top level subtrees of a parse tree (the children of the given root) on multiple threads.
+  /// This suits listeners whose work for one subtree doesn't depend on the others, e.g. symbol collection
+  /// per declaration.
+  ///
+  /// The subtrees are split into tasks of consecutive subtrees. Each task gets its own listener instance
+  /// from the factory and walks its subtrees in order. The tasks are distributed over the worker threads,
+  /// which take their tasks from the front of their own queue and steal from the back of other queues when
+  /// they run out of work. When all tasks are done, the merge function is called on the calling thread for
+  /// each listener, in the order of the tasks. So the merged result doesn't depend on thread scheduling.
+  ///
+  /// The root node itself is not visited. Listeners must not modify the tree or share mutable state.
+  ///
+  /// The worker threads belong to a WorkerPool, which keeps them waiting between walks. A walker creates
+  /// its own pool, or uses one given by the caller, e.g. to share the threads between several walkers.
+  class ANTLR4CPP_PUBLIC ParallelParseTreeWalker {
+  public:
+    typedef std::function<std::unique_ptr<ParseTreeListener> ()> ListenerFactory;
+    typedef std::function<void (ParseTreeListener *listener)> MergeFunction;
+
+    /// A set of threads which run jobs together with the calling thread. The threads are started by the
+    /// constructor and wait for jobs until the pool is destroyed.
+    class ANTLR4CPP_PUBLIC WorkerPool {
+    public:
+      typedef std::function<void (size_t worker)> Job;
+
+      /// threadCount 0 uses the number of hardware threads. The pool starts threadCount - 1 threads,
+      /// because the calling thread of run() is one of the workers. If not all threads can be started,
+      /// the pool works with fewer.
+      WorkerPool(size_t threadCount = 0);
+      WorkerPool(WorkerPool const&) = delete;
+      ~WorkerPool();
+
+      WorkerPool& operator=(WorkerPool const&) = delete;
+
+      /// The number of workers, including the calling thread.
+      size_t getThreadCount() const;
+
+      /// Calls job(0) on the calling thread and job(1) .. job(workerCount - 1) on the threads of the pool,
+      /// and returns when all calls are done. Returns the number of workers which ran the job, which is less
+      /// than workerCount if the pool has fewer threads or is busy with the job of another run() call (e.g.
+      /// a walk started from within a listener). In the latter case only job(0) is called. The job must not
+      /// throw.
+      size_t run(size_t workerCount, const Job &job);
+
+    private:
+      struct State;
+      std::unique_ptr<State> _state;
+    };
+
+    /// Creates a walker with its own pool of threadCount workers (see WorkerPool).
+    ParallelParseTreeWalker(size_t threadCount = 0);
+
+    /// Creates a walker which runs on the threads of the given pool.
+    ParallelParseTreeWalker(Ref<WorkerPool> pool);
+
+    virtual ~ParallelParseTreeWalker();
+
+    /// The number of workers of the pool, including the calling thread.
+    size_t getThreadCount() const;
+
+    Ref<WorkerPool> getWorkerPool() const;
+
+    /// The number of top level subtrees per task. Smaller tasks balance the load better, but need more
+    /// listener instances and merge calls. 0 (the default) means about 8 tasks per thread.
+    void setGranularity(size_t subtreesPerTask);
+    size_t getGranularity() const;
+
+    /// Walks all children of t as described above. If a listener throws, the remaining tasks are skipped,
+    /// nothing is merged and the exception of the first failing task is rethrown.
+    virtual void walk(ParseTree *t, const ListenerFactory &createListener, const MergeFunction &merge) const;
+
+  private:
+    Ref<WorkerPool> _pool;
+    size_t _granularity;
+  };
+
+} // namespace tree
+} // namespace antlr4
@@ -3,13 +3,193 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
+#include "tree/ParseTreeDispatcher.h"
+#include "tree/TerminalNode.h"
+#include "Token.h"
+#include "RuleContext.h"
+
 #include "tree/ParseTree.h"
 
 using namespace antlr4::tree;
 
-ParseTree::ParseTree() : parent(nullptr) {
+ParseTree::ParseTree(ParseTreeType type)
+  : parent(nullptr), _treeType(static_cast<uint32_t>(type)), _ruleIndexOrTokenType(NO_RULE_INDEX_OR_TOKEN_TYPE),
+    _ordinal(NO_ORDINAL) {
 }
 
 bool ParseTree::operator == (const ParseTree &other) const {
   return &other == this;
 }
+
+void ParseTree::dispatch(ParseTreeDispatcher *dispatcher, void *result) {
+  dispatcher->dispatchChildren(this, result);
+}
+
+void ParseTree::setRuleIndexOrTokenType(size_t value) {
+  if (getTreeType() != ParseTreeType::RULE) {
+    ++value; // EOF (= INVALID_INDEX) becomes 0.
+  }
+  _ruleIndexOrTokenType = value < NO_RULE_INDEX_OR_TOKEN_TYPE ? static_cast<uint32_t>(value) : NO_RULE_INDEX_OR_TOKEN_TYPE;
+}
+
+size_t ParseTree::getRuleIndexOrTokenTypeSlow() const {
+  if (getTreeType() == ParseTreeType::RULE) {
+    return static_cast<const RuleContext *>(this)->getRuleIndex();
+  }
+
+  // getSymbol() is not const, but doesn't change the node.
+  Token *symbol = const_cast<TerminalNode *>(static_cast<const TerminalNode *>(this))->getSymbol();
+  return symbol == nullptr ? INVALID_INDEX : symbol->getType();
+}
+
+//------------------ ParseTreeTracker ----------------------------------------------------------------------------------
+
+namespace {
+
+  inline char* alignPointer(char *p, size_t alignment) {
+    uintptr_t value = reinterpret_cast<uintptr_t>(p);
+    return p + ((alignment - value % alignment) % alignment);
+  }
+
+}
+
+ParseTreeTracker::ParseTreeTracker()
+  : _usedBlocks(0), _position(nullptr), _end(nullptr), _reuseMemory(false), _ordinalCount(0) {
+}
+
+ParseTreeTracker::~ParseTreeTracker() {
+  _reuseMemory = false;
+  reset();
+}
+
+void ParseTreeTracker::reset() {
+  // Nodes only refer to other nodes by pointer, so the order of destruction doesn't matter.
+  for (size_t i = 0; i < _usedBlocks; ++i) {
+    char *block = _blocks[i];
+    char *entries = i < _filledBlockEnds.size() ? _filledBlockEnds[i] : _end;
+    for (char *entry = entries; entry < block + BLOCK_SIZE; entry += sizeof(uint16_t)) {
+      uint16_t offset = *reinterpret_cast<uint16_t *>(entry);
+      if (offset != NO_INSTANCE)
+        reinterpret_cast<ParseTree *>(block + offset)->~ParseTree();
+    }
+  }
+  _filledBlockEnds.clear();
+
+  for (auto entry : _largeInstances)
+    entry->~ParseTree();
+  _largeInstances.clear();
+
+  for (auto entry : _largeAllocations)
+    ::operator delete(entry);
+  _largeAllocations.clear();
+
+  if (!_reuseMemory) {
+    for (auto block : _blocks)
+      ::operator delete(block);
+    _blocks.clear();
+  }
+  _usedBlocks = 0;
+  _position = nullptr;
+  _end = nullptr;
+  _ordinalCount = 0;
+}
+
+void ParseTreeTracker::setReuseMemory(bool reuse) {
+  _reuseMemory = reuse;
+}
+
+bool ParseTreeTracker::getReuseMemory() const {
+  return _reuseMemory;
+}
+
+void ParseTreeTracker::adopt(ParseTreeTracker &other) {
+  if (&other == this) {
+    return;
+  }
+
+  // The used blocks of the other tracker become filled blocks here. They go in front of the own ones,
+  // so that the current block stays the last used block.
+  std::vector<char *> ends = other._filledBlockEnds;
+  if (other._position != nullptr) {
+    ends.push_back(other._end);
+  }
+  _blocks.reserve(_blocks.size() + other._usedBlocks);
+  _filledBlockEnds.reserve(_filledBlockEnds.size() + ends.size());
+  _largeInstances.reserve(_largeInstances.size() + other._largeInstances.size());
+  _largeAllocations.reserve(_largeAllocations.size() + other._largeAllocations.size());
+
+  _blocks.insert(_blocks.begin(), other._blocks.begin(), other._blocks.begin() + other._usedBlocks);
+  _filledBlockEnds.insert(_filledBlockEnds.begin(), ends.begin(), ends.end());
+  _usedBlocks += other._usedBlocks;
+  _largeInstances.insert(_largeInstances.end(), other._largeInstances.begin(), other._largeInstances.end());
+  _largeAllocations.insert(_largeAllocations.end(), other._largeAllocations.begin(), other._largeAllocations.end());
+
+  other._blocks.erase(other._blocks.begin(), other._blocks.begin() + other._usedBlocks);
+  other._filledBlockEnds.clear();
+  other._largeInstances.clear();
+  other._largeAllocations.clear();
+  other._usedBlocks = 0;
+  other._position = nullptr;
+  other._end = nullptr;
+
+  _ordinalCount = std::max(_ordinalCount, other._ordinalCount);
+}
+
+size_t ParseTreeTracker::getOrdinalCount() const {
+  return _ordinalCount;
+}
+
+void ParseTreeTracker::reserveOrdinals(size_t count) {
+  _ordinalCount = std::max(_ordinalCount, count);
+}
+
+void* ParseTreeTracker::allocate(size_t size, size_t alignment, uint16_t *&entry, size_t &offset) {
+  static_assert(BLOCK_SIZE <= 0x10000, "Block offsets must fit into the 16 bit instance list entries");
+
+  if (size + alignment > BLOCK_SIZE / 4) {
+    _largeInstances.reserve(_largeInstances.size() + 1);
+    _largeAllocations.reserve(_largeAllocations.size() + 1);
+    void *memory = ::operator new(size + alignment);
+    _largeAllocations.push_back(memory);
+    entry = nullptr;
+    offset = 0;
+    return alignPointer(static_cast<char *>(memory), alignment);
+  }
+
+  char *result = alignPointer(_position, alignment);
+  if (_position == nullptr || result + size + sizeof(uint16_t) > _end) {
+    if (_usedBlocks == _blocks.size()) {
+      _blocks.reserve(_blocks.size() + 1);
+      _blocks.push_back(static_cast<char *>(::operator new(BLOCK_SIZE)));
+    }
+    if (_position != nullptr) {
+      _filledBlockEnds.push_back(_end);
+    }
+    _position = _blocks[_usedBlocks++];
+    _end = _position + BLOCK_SIZE;
+    result = alignPointer(_position, alignment);
+  }
+
+  _end -= sizeof(uint16_t);
+  entry = reinterpret_cast<uint16_t *>(_end);
+  *entry = NO_INSTANCE;
+  offset = static_cast<size_t>(result - _blocks[_usedBlocks - 1]);
+
+  _position = result + size;
+  return result;
+}
+
+void ParseTreeTracker::track(ParseTree *instance, void *memory, uint16_t *entry, size_t offset) {
+  if (_ordinalCount < ParseTree::NO_ORDINAL) {
+    instance->_ordinal = static_cast<uint32_t>(_ordinalCount++);
+  }
+
+  if (entry == nullptr) {
+    _largeInstances.push_back(instance); // Capacity reserved in allocate().
+    return;
+  }
+
+  // The ParseTree part is not necessarily at the start of the instance (e.g. with virtual inheritance).
+  offset += static_cast<size_t>(reinterpret_cast<char *>(instance) - static_cast<char *>(memory));
+  *entry = static_cast<uint16_t>(offset);
+}
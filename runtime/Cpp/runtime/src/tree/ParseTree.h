@@ -6,10 +6,18 @@
 #pragma once
 
 #include "support/Any.h"
+#include "tree/ChildList.h"
 
 namespace antlr4 {
 namespace tree {
 
+  /// The kind of a parse tree node, see ParseTree::getTreeType().
+  enum class ParseTreeType : uint32_t {
+    TERMINAL = 1,
+    ERROR = 2,
+    RULE = 3,
+  };
+
   /// An interface to access the tree of <seealso cref="RuleContext"/> objects created
   /// during a parse that makes the data structure look like a simple parse tree.
   /// This node represents both internal nodes, rule invocations,
@@ -19,7 +27,7 @@ namespace tree {
   // ml: This class unites 4 Java classes: RuleNode, ParseTree, SyntaxTree and Tree.
   class ANTLR4CPP_PUBLIC ParseTree {
   public:
-    ParseTree();
+    ParseTree(ParseTreeType type);
     ParseTree(ParseTree const&) = delete;
     virtual ~ParseTree() {}
 
@@ -35,7 +43,36 @@ namespace tree {
     /// operation because we don't the need to track the details about
     /// how we parse this rule.
     // ml: memory is not managed here, but by the owning class. This is just for the structure.
-    std::vector<ParseTree *> children;
+    ChildList children;
+
+    /// The kind of this node: a rule context (RuleContext), a token (TerminalNode) or an error node
+    /// (ErrorNode, which is also a TerminalNode). Checking it is a lot cheaper than a dynamic_cast.
+    /// For nodes of kind RULE and TERMINAL a static_cast to RuleContext or TerminalNode is safe.
+    ParseTreeType getTreeType() const {
+      return static_cast<ParseTreeType>(_treeType);
+    }
+
+    /// The rule index of a rule context, or the token type of the symbol of a terminal or error node. Both are
+    /// stored in the node (the rule index when the parser enters the rule, the token type when the symbol is set),
+    /// so that filters like ParserRuleContext::getRuleContext(ruleIndex, i) or XPath steps compare integers instead
+    /// of calling RuleContext::getRuleIndex() and TerminalNode::getSymbol()->getType(). For nodes without a stored
+    /// value (e.g. contexts created by hand) the virtual methods are called instead.
+    size_t getRuleIndexOrTokenType() const {
+      if (_ruleIndexOrTokenType == NO_RULE_INDEX_OR_TOKEN_TYPE) {
+        return getRuleIndexOrTokenTypeSlow();
+      }
+      if (static_cast<ParseTreeType>(_treeType) == ParseTreeType::RULE) {
+        return _ruleIndexOrTokenType;
+      }
+      return static_cast<size_t>(_ruleIndexOrTokenType) - 1; // EOF is stored as 0.
+    }
+
+    /// A number which identifies this node among all nodes created by the same ParseTreeTracker. The nodes of
+    /// a parser are numbered 0, 1, 2... in the order of their creation, which makes the ordinal a suitable
+    /// index into a vector (see DenseParseTreeProperty). INVALID_INDEX for nodes not created by a tracker.
+    size_t getOrdinal() const {
+      return _ordinal == NO_ORDINAL ? INVALID_INDEX : _ordinal;
+    }
 
     /// Print out a whole tree, not just a node, in LISP format
     /// {@code (root child1 .. childN)}. Print just a node if this is a leaf.
@@ -52,6 +89,11 @@ namespace tree {
     // ml: This has been changed to use Any instead of a template parameter, to avoid the need of a virtual template function.
     virtual antlrcpp::Any accept(ParseTreeVisitor *visitor) = 0;
 
+    /// The double dispatch method of typed visitors (see TypedParseTreeVisitor), which stores its result
+    /// in the DispatchResult given by result. Generated contexts call their typed dispatch method on a
+    /// dispatcher for their grammar. The default implementation calls dispatcher->dispatchChildren().
+    virtual void dispatch(ParseTreeDispatcher *dispatcher, void *result);
+
     /// Return the combined text of all leaf nodes. Does not get any
     /// off-channel tokens (if any) so won't return whitespace and
     /// comments if they are sent to parser on hidden channel.
@@ -74,29 +116,106 @@ namespace tree {
      * EOF is unspecified.</p>
      */
     virtual misc::Interval getSourceInterval() = 0;
+
+  protected:
+    // The ParseTreeType and the value returned by getRuleIndexOrTokenType() share 32 bits. Token types are
+    // stored + 1, so that EOF becomes 0.
+    uint32_t _treeType : 8;
+    uint32_t _ruleIndexOrTokenType : 24;
+
+    static const uint32_t NO_RULE_INDEX_OR_TOKEN_TYPE = 0xFFFFFF;
+
+    void setTreeType(ParseTreeType type) {
+      _treeType = static_cast<uint32_t>(type);
+    }
+
+    /// Stores the value returned by getRuleIndexOrTokenType(), which must be the rule index for rule contexts
+    /// and the token type for terminal and error nodes. Values which don't fit are not stored.
+    void setRuleIndexOrTokenType(size_t value);
+
+  private:
+    friend class ParseTreeTracker;
+    friend class antlr4::Parser; // Stores the rule index of entered contexts.
+
+    static const uint32_t NO_ORDINAL = 0xFFFFFFFF;
+
+    uint32_t _ordinal; // Next to the 32 bit type fields, so that all take 8 bytes.
+
+    size_t getRuleIndexOrTokenTypeSlow() const;
   };
 
   // A class to help managing ParseTree instances without the need of a shared_ptr.
+  // The instances are constructed in place in large memory blocks (bump pointer allocation), which
+  // are released in bulk by reset(), after the destructors of all instances have run.
+  // Each block lists its instances at its end, as 16 bit offsets growing downwards from the block end.
   class ANTLR4CPP_PUBLIC ParseTreeTracker {
   public:
+    static const size_t BLOCK_SIZE = 64 * 1024;
+
+    ParseTreeTracker();
+    ParseTreeTracker(ParseTreeTracker const&) = delete;
+    ~ParseTreeTracker();
+
+    ParseTreeTracker& operator=(ParseTreeTracker const&) = delete;
+
     template<typename T, typename ... Args>
     T* createInstance(Args&& ... args) {
       static_assert(std::is_base_of<ParseTree, T>::value, "Argument must be a parse tree type");
-      T* result = new T(args...);
-      _allocated.push_back(result);
+      uint16_t *entry;
+      size_t offset;
+      void *memory = allocate(sizeof(T), alignof(T), entry, offset);
+      T* result = new (memory) T(std::forward<Args>(args)...);
+      track(result, memory, entry, offset);
       return result;
     }
 
-    void reset() {
-      for (auto entry : _allocated)
-        delete entry;
-      _allocated.clear();
-    }
+    /// Destroys all instances and releases their memory (or keeps it for the next parse run,
+    /// see setReuseMemory()).
+    void reset();
+
+    /// If true, reset() keeps the memory blocks for the instances created after it, e.g. in the next
+    /// parse run with the same parser. This avoids allocating the blocks again, but the memory stays in
+    /// use until the tracker is destroyed. Default is false.
+    void setReuseMemory(bool reuse);
+    bool getReuseMemory() const;
+
+    /// Takes over all instances of the other tracker, which is empty afterwards. They are destroyed
+    /// together with the own instances by the next reset(). The adopted instances keep their ordinals.
+    void adopt(ParseTreeTracker &other);
+
+    /// The number of ordinals given out since the last reset(). All instances of this tracker have an
+    /// ordinal below this number.
+    size_t getOrdinalCount() const;
+
+    /// Continues numbering instances at count, if that is more than getOrdinalCount(). Used to give the nodes
+    /// of this tracker ordinals which don't collide with those of another tracker.
+    void reserveOrdinals(size_t count);
 
   private:
-    std::vector<ParseTree *> _allocated;
-  };
+    static const uint16_t NO_INSTANCE = 0xFFFF; // Marks an entry whose instance could not be constructed.
+
+    std::vector<char *> _blocks; // Each BLOCK_SIZE bytes.
+    size_t _usedBlocks;
+    char *_position; // Next free byte in the current block.
+    char *_end;      // End of the free space in the current block (= start of its instance list).
+
+    // The start of the instance list of each used block, except for the current one.
+    std::vector<char *> _filledBlockEnds;
 
+    // Instances too large for a block get their own memory, which is never reused.
+    std::vector<ParseTree *> _largeInstances;
+    std::vector<void *> _largeAllocations;
+
+    bool _reuseMemory;
+    size_t _ordinalCount;
+
+    // Reserves memory for an instance. For memory in a block, entry is set to a new entry in the instance list
+    // of that block and offset to the position of the memory in the block. Otherwise entry is null.
+    void* allocate(size_t size, size_t alignment, uint16_t *&entry, size_t &offset);
+
+    // Records a constructed instance, using the values returned by allocate().
+    void track(ParseTree *instance, void *memory, uint16_t *entry, size_t offset);
+  };
 
 } // namespace tree
 } // namespace antlr4
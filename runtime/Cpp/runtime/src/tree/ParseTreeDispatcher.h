@@ -0,0 +1,75 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace tree {
+
+  /// The receiving side of ParseTree::dispatch, which is the double dispatch method of typed visitors
+  /// (see TypedParseTreeVisitor). Unlike ParseTree::accept it doesn't return an antlrcpp::Any. The result
+  /// is instead stored in a DispatchResult<T>, owned by the caller, whose address is passed through as
+  /// an untyped pointer.
+  ///
+  /// Generated parsers (with the typedVisitor option) derive an XDispatcher for grammar X from this class,
+  /// with one dispatch method per context class. A context only calls these methods if the dispatcher
+  /// was created for its grammar, which is identified by the grammar id.
+  class ANTLR4CPP_PUBLIC ParseTreeDispatcher {
+  public:
+    /// Identifies the grammar this dispatcher handles (nullptr for none).
+    const void * const grammarId;
+
+    virtual ~ParseTreeDispatcher();
+
+    /// Called for all rule contexts which have no typed dispatch method for this dispatcher.
+    virtual void dispatchChildren(ParseTree *node, void *result) = 0;
+
+  protected:
+    ParseTreeDispatcher(const void *grammarId = nullptr) : grammarId(grammarId) {}
+  };
+
+  /// Storage for the result of a typed dispatch. T doesn't need to be default constructible.
+  template<typename T>
+  class DispatchResult {
+  public:
+    DispatchResult() : _hasValue(false) {}
+    DispatchResult(DispatchResult const&) = delete;
+
+    ~DispatchResult() {
+      if (_hasValue) {
+        value().~T();
+      }
+    }
+
+    DispatchResult& operator = (DispatchResult const&) = delete;
+
+    void set(T &&result) {
+      if (_hasValue) {
+        value() = std::move(result);
+      } else {
+        new (&_storage) T(std::move(result));
+        _hasValue = true;
+      }
+    }
+
+    /// Moves the result out. Must only be called after set().
+    T take() {
+      assert(_hasValue);
+      return std::move(value());
+    }
+
+  private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage;
+    bool _hasValue;
+
+    T& value() {
+      return *reinterpret_cast<T *>(&_storage);
+    }
+  };
+
+} // namespace tree
+} // namespace antlr4
@@ -0,0 +1,229 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "tree/ParseTreeRange.h"
+
+using namespace antlr4;
+using namespace antlr4::tree;
+
+namespace {
+
+  const unsigned RULE_BIT = 1 << static_cast<size_t>(ParseTreeType::RULE);
+  const unsigned TERMINAL_BIT = 1 << static_cast<size_t>(ParseTreeType::TERMINAL);
+  const unsigned ERROR_BIT = 1 << static_cast<size_t>(ParseTreeType::ERROR);
+
+}
+
+//------------------ ParseTreeFilter -----------------------------------------------------------------------------------
+
+ParseTreeFilter::ParseTreeFilter() : ParseTreeFilter(RULE_BIT | TERMINAL_BIT | ERROR_BIT) {
+}
+
+ParseTreeFilter::ParseTreeFilter(unsigned types)
+  : _types(types), _ruleIndex(INVALID_INDEX), _hasTokenType(false), _tokenType(0) {
+}
+
+ParseTreeFilter ParseTreeFilter::rules() {
+  return ParseTreeFilter(RULE_BIT);
+}
+
+ParseTreeFilter ParseTreeFilter::rules(size_t ruleIndex) {
+  ParseTreeFilter result(RULE_BIT);
+  result._ruleIndex = ruleIndex;
+  return result;
+}
+
+ParseTreeFilter ParseTreeFilter::tokens() {
+  return ParseTreeFilter(TERMINAL_BIT | ERROR_BIT);
+}
+
+ParseTreeFilter ParseTreeFilter::tokens(size_t tokenType) {
+  ParseTreeFilter result(TERMINAL_BIT | ERROR_BIT);
+  result._hasTokenType = true;
+  result._tokenType = tokenType;
+  return result;
+}
+
+ParseTreeFilter ParseTreeFilter::errors() {
+  return ParseTreeFilter(ERROR_BIT);
+}
+
+ParseTreeFilter ParseTreeFilter::operator && (const ParseTreeFilter &other) const {
+  ParseTreeFilter result(_types & other._types);
+
+  result._ruleIndex = _ruleIndex;
+  if (other._ruleIndex != INVALID_INDEX) {
+    if (_ruleIndex != INVALID_INDEX && _ruleIndex != other._ruleIndex) {
+      result._types &= ~RULE_BIT; // Contradicting conditions.
+    }
+    result._ruleIndex = other._ruleIndex;
+  }
+
+  result._hasTokenType = _hasTokenType || other._hasTokenType;
+  result._tokenType = _hasTokenType ? _tokenType : other._tokenType;
+  if (_hasTokenType && other._hasTokenType && _tokenType != other._tokenType) {
+    result._types &= ~(TERMINAL_BIT | ERROR_BIT);
+  }
+
+  if (_predicate && other._predicate) {
+    std::function<bool (ParseTree *)> first = _predicate;
+    std::function<bool (ParseTree *)> second = other._predicate;
+    result._predicate = [first, second](ParseTree *node) { return first(node) && second(node); };
+  } else {
+    result._predicate = _predicate ? _predicate : other._predicate;
+  }
+
+  return result;
+}
+
+ParseTreeFilter ParseTreeFilter::operator && (std::function<bool (ParseTree *)> predicate) const {
+  ParseTreeFilter other;
+  other._predicate = std::move(predicate);
+  return *this && other;
+}
+
+//------------------ ParseTreeIterator ---------------------------------------------------------------------------------
+
+ParseTreeIterator::ParseTreeIterator()
+  : _current(nullptr), _order(TraversalOrder::PRE_ORDER), _skipChildren(false) {
+}
+
+ParseTreeIterator::ParseTreeIterator(ParseTree *root, TraversalOrder order, const ParseTreeFilter &filter)
+  : _current(nullptr), _order(order), _filter(filter), _skipChildren(false) {
+  if (root == nullptr) {
+    return;
+  }
+
+  if (_order == TraversalOrder::PRE_ORDER) {
+    _current = root;
+  } else {
+    descend(root);
+  }
+
+  if (!_filter.matches(_current)) {
+    ++*this;
+  }
+}
+
+ParseTreeIterator& ParseTreeIterator::operator ++ () {
+  do {
+    step();
+  } while (_current != nullptr && !_filter.matches(_current));
+  return *this;
+}
+
+ParseTreeIterator ParseTreeIterator::operator ++ (int) {
+  ParseTreeIterator result = *this;
+  ++*this;
+  return result;
+}
+
+void ParseTreeIterator::skipChildren() {
+  _skipChildren = _order == TraversalOrder::PRE_ORDER;
+}
+
+void ParseTreeIterator::step() {
+  if (_order == TraversalOrder::PRE_ORDER) {
+    bool skip = _skipChildren;
+    _skipChildren = false;
+    if (!skip && !_current->children.empty()) {
+      _path.push_back({ _current, 0 });
+      _current = _current->children[0];
+      return;
+    }
+
+    while (!_path.empty()) {
+      std::pair<ParseTree *, size_t> &top = _path.back();
+      if (++top.second < top.first->children.size()) {
+        _current = top.first->children[top.second];
+        return;
+      }
+      _path.pop_back();
+    }
+    _current = nullptr;
+    return;
+  }
+
+  // Post-order: continue with the next sibling's subtree or, after the last sibling, with the parent.
+  if (_path.empty()) {
+    _current = nullptr;
+    return;
+  }
+
+  std::pair<ParseTree *, size_t> &top = _path.back();
+  if (++top.second < top.first->children.size()) {
+    descend(top.first->children[top.second]);
+  } else {
+    _current = top.first;
+    _path.pop_back();
+  }
+}
+
+void ParseTreeIterator::descend(ParseTree *node) {
+  while (!node->children.empty()) {
+    _path.push_back({ node, 0 });
+    node = node->children[0];
+  }
+  _current = node;
+}
+
+//------------------ ParseTreeRange ------------------------------------------------------------------------------------
+
+ParseTreeRange::ParseTreeRange(ParseTree *root, TraversalOrder order, const ParseTreeFilter &filter)
+  : _root(root), _order(order), _filter(filter) {
+}
+
+ParseTreeIterator ParseTreeRange::begin() const {
+  return ParseTreeIterator(_root, _order, _filter);
+}
+
+ParseTreeIterator ParseTreeRange::end() const {
+  return ParseTreeIterator();
+}
+
+bool ParseTreeRange::empty() const {
+  return first() == nullptr;
+}
+
+ParseTree* ParseTreeRange::first() const {
+  return *begin();
+}
+
+std::vector<ParseTree *> ParseTreeRange::toVector() const {
+  // A single pass, the node count isn't known without walking the tree.
+  std::vector<ParseTree *> result;
+  for (ParseTree *node : *this) {
+    result.push_back(node);
+  }
+  return result;
+}
+
+ParseTreeRange ParseTreeRange::filter(const ParseTreeFilter &filter) const {
+  return ParseTreeRange(_root, _order, _filter && filter);
+}
+
+ParseTreeRange ParseTreeRange::filter(std::function<bool (ParseTree *)> predicate) const {
+  return ParseTreeRange(_root, _order, _filter && std::move(predicate));
+}
+
+ParseTreeRange ParseTreeRange::rules() const {
+  return filter(ParseTreeFilter::rules());
+}
+
+ParseTreeRange ParseTreeRange::rules(size_t ruleIndex) const {
+  return filter(ParseTreeFilter::rules(ruleIndex));
+}
+
+ParseTreeRange ParseTreeRange::tokens() const {
+  return filter(ParseTreeFilter::tokens());
+}
+
+ParseTreeRange ParseTreeRange::tokens(size_t tokenType) const {
+  return filter(ParseTreeFilter::tokens(tokenType));
+}
+
+ParseTreeRange ParseTreeRange::errors() const {
+  return filter(ParseTreeFilter::errors());
+}
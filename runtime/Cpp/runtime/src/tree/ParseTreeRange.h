@@ -0,0 +1,161 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "RuleContext.h"
+#include "tree/TerminalNode.h"
+#include "Token.h"
+
+namespace antlr4 {
+namespace tree {
+
+  /// The order in which a ParseTreeRange visits the nodes of a subtree.
+  enum class TraversalOrder : size_t {
+    PRE_ORDER = 1, // A node before its children.
+    POST_ORDER = 2, // A node after its children.
+  };
+
+  /// Selects the nodes of a ParseTreeRange by their kind, rule index or token type and an optional predicate.
+  /// Token conditions match terminal and error nodes.
+  class ANTLR4CPP_PUBLIC ParseTreeFilter {
+  public:
+    /// Matches all nodes.
+    ParseTreeFilter();
+
+    static ParseTreeFilter rules();
+    static ParseTreeFilter rules(size_t ruleIndex);
+    static ParseTreeFilter tokens();
+    static ParseTreeFilter tokens(size_t tokenType);
+    static ParseTreeFilter errors();
+
+    /// Returns a filter which matches only the nodes matched by both filters.
+    ParseTreeFilter operator && (const ParseTreeFilter &other) const;
+
+    /// Returns a filter which in addition requires the predicate to be true.
+    ParseTreeFilter operator && (std::function<bool (ParseTree *)> predicate) const;
+
+    bool matches(ParseTree *node) const {
+      ParseTreeType type = node->getTreeType();
+      if ((_types & (1 << static_cast<size_t>(type))) == 0) {
+        return false;
+      }
+
+      if (type == ParseTreeType::RULE) {
+        if (_ruleIndex != INVALID_INDEX && node->getRuleIndexOrTokenType() != _ruleIndex) {
+          return false;
+        }
+      } else if (_hasTokenType && node->getRuleIndexOrTokenType() != _tokenType) {
+        return false;
+      }
+
+      return !_predicate || _predicate(node);
+    }
+
+  private:
+    unsigned _types; // Bit n is set if nodes of the ParseTreeType with value n are included.
+    size_t _ruleIndex; // INVALID_INDEX for any rule.
+    bool _hasTokenType;
+    size_t _tokenType;
+    std::function<bool (ParseTree *)> _predicate;
+
+    ParseTreeFilter(unsigned types);
+  };
+
+  /// An input iterator over the nodes of a subtree, which are produced one at a time while iterating.
+  /// Only the path from the root to the current node is kept, so there's no allocation per node.
+  /// Copies can be advanced independently, but that means copying the path, so algorithms should
+  /// make a single pass. The tree must not be modified while it is being iterated.
+  class ANTLR4CPP_PUBLIC ParseTreeIterator {
+  public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef ParseTree* value_type;
+    typedef ptrdiff_t difference_type;
+    typedef ParseTree* const* pointer;
+    typedef ParseTree* const& reference;
+
+    /// Creates the end iterator.
+    ParseTreeIterator();
+    ParseTreeIterator(ParseTree *root, TraversalOrder order, const ParseTreeFilter &filter);
+
+    reference operator * () const {
+      return _current;
+    }
+
+    ParseTreeIterator& operator ++ ();
+    ParseTreeIterator operator ++ (int);
+
+    bool operator == (const ParseTreeIterator &other) const {
+      return _current == other._current;
+    }
+
+    bool operator != (const ParseTreeIterator &other) const {
+      return _current != other._current;
+    }
+
+    /// In pre-order: don't visit the children of the current node, continue with its next sibling instead.
+    /// Has no effect in post-order, where the children have already been visited.
+    void skipChildren();
+
+  private:
+    ParseTree *_current; // nullptr at the end.
+    TraversalOrder _order;
+    ParseTreeFilter _filter;
+    bool _skipChildren;
+
+    /// The ancestors of the current node below the root (inclusive), each with the index of the child
+    /// which is on the path to the current node.
+    std::vector<std::pair<ParseTree *, size_t>> _path;
+
+    void step();
+
+    /// Post-order: moves to the first leaf of the given subtree.
+    void descend(ParseTree *node);
+  };
+
+  /// A lazily evaluated sequence of nodes of a subtree, for use with range based for loops and
+  /// algorithms. Nodes are only visited as far as the caller iterates, so stopping at the first match
+  /// costs nothing for the rest of the tree, e.g.:
+  ///
+  ///   for (ParseTree *node : ParseTreeRange(tree).tokens(MyLexer::ID)) { ... }
+  ///   ParseTree *firstCall = ParseTreeRange(tree).rules(MyParser::RuleCall).first();
+  class ANTLR4CPP_PUBLIC ParseTreeRange {
+  public:
+    typedef ParseTreeIterator iterator;
+    typedef ParseTreeIterator const_iterator;
+
+    /// Includes the root itself.
+    ParseTreeRange(ParseTree *root, TraversalOrder order = TraversalOrder::PRE_ORDER,
+                   const ParseTreeFilter &filter = ParseTreeFilter());
+
+    ParseTreeIterator begin() const;
+    ParseTreeIterator end() const;
+
+    bool empty() const;
+
+    /// Returns the first node of the range or nullptr if it is empty.
+    ParseTree* first() const;
+
+    /// Visits the whole range and returns all nodes.
+    std::vector<ParseTree *> toVector() const;
+
+    /// Returns a range with only those nodes of this range, which also match the given filter or predicate.
+    ParseTreeRange filter(const ParseTreeFilter &filter) const;
+    ParseTreeRange filter(std::function<bool (ParseTree *)> predicate) const;
+
+    ParseTreeRange rules() const;
+    ParseTreeRange rules(size_t ruleIndex) const;
+    ParseTreeRange tokens() const;
+    ParseTreeRange tokens(size_t tokenType) const;
+    ParseTreeRange errors() const;
+
+  private:
+    ParseTree *_root;
+    TraversalOrder _order;
+    ParseTreeFilter _filter;
+  };
+
+} // namespace tree
+} // namespace antlr4
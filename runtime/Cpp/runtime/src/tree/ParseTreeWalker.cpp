@@ -21,12 +21,17 @@ ParseTreeWalker::~ParseTreeWalker() {
 }
 
 void ParseTreeWalker::walk(ParseTreeListener *listener, ParseTree *t) const {
-  if (is<ErrorNode *>(t)) {
-    listener->visitErrorNode(dynamic_cast<ErrorNode *>(t));
-    return;
-  } else if (is<TerminalNode *>(t)) {
-    listener->visitTerminal(dynamic_cast<TerminalNode *>(t));
-    return;
+  switch (t->getTreeType()) {
+    case ParseTreeType::ERROR:
+      listener->visitErrorNode(dynamic_cast<ErrorNode *>(t));
+      return;
+
+    case ParseTreeType::TERMINAL:
+      listener->visitTerminal(static_cast<TerminalNode *>(t));
+      return;
+
+    default:
+      break;
   }
 
   enterRule(listener, t);
@@ -5,5 +5,8 @@
 
 #include "tree/TerminalNode.h"
 
+antlr4::tree::TerminalNode::TerminalNode() : ParseTree(ParseTreeType::TERMINAL) {
+}
+
 antlr4::tree::TerminalNode::~TerminalNode() {
 }
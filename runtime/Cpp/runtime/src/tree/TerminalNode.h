@@ -12,10 +12,14 @@ namespace tree {
 
   class ANTLR4CPP_PUBLIC TerminalNode : public ParseTree {
   public:
+    TerminalNode();
     ~TerminalNode() override;
 
     virtual Token* getSymbol() = 0;
 
+    /// Replaces the token of this node, e.g. when a subtree is moved to another token stream.
+    virtual void setSymbol(Token *symbol) = 0;
+
     /** Set the parent for this leaf node.
      *
      *  Technically, this is not backward compatible as it changes
@@ -14,12 +14,24 @@ using namespace antlr4;
 using namespace antlr4::tree;
 
 TerminalNodeImpl::TerminalNodeImpl(Token *symbol_) : symbol(symbol_) {
+  if (symbol != nullptr) {
+    setRuleIndexOrTokenType(symbol->getType());
+  }
 }
 
 Token* TerminalNodeImpl::getSymbol() {
   return symbol;
 }
 
+void TerminalNodeImpl::setSymbol(Token *symbol) {
+  this->symbol = symbol;
+  if (symbol != nullptr) {
+    setRuleIndexOrTokenType(symbol->getType());
+  } else {
+    _ruleIndexOrTokenType = NO_RULE_INDEX_OR_TOKEN_TYPE;
+  }
+}
+
 void TerminalNodeImpl::setParent(RuleContext *parent_) {
   this->parent = parent_;
 }
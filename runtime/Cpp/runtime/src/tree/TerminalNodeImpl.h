@@ -12,11 +12,14 @@ namespace tree {
 
   class ANTLR4CPP_PUBLIC TerminalNodeImpl : public virtual TerminalNode {
   public:
+    /// Use setSymbol() to replace the symbol, which also updates the token type stored in the node
+    /// (see ParseTree::getRuleIndexOrTokenType()).
     Token *symbol;
 
     TerminalNodeImpl(Token *symbol);
 
     virtual Token* getSymbol() override;
+    virtual void setSymbol(Token *symbol) override;
     virtual void setParent(RuleContext *parent) override;
     virtual misc::Interval getSourceInterval() override;
 
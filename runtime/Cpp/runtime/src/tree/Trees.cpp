@@ -13,6 +13,7 @@
 #include "Token.h"
 #include "CommonToken.h"
 #include "misc/Predicate.h"
+#include "tree/ParseTreeRange.h"
 
 #include "tree/Trees.h"
 
@@ -36,48 +37,214 @@ std::string Trees::toStringTree(ParseTree *t, Parser *recog) {
 }
 
 std::string Trees::toStringTree(ParseTree *t, const std::vector<std::string> &ruleNames) {
-  std::string temp = antlrcpp::escapeWhitespace(Trees::getNodeText(t, ruleNames), false);
-  if (t->children.empty()) {
-    return temp;
+  std::stringstream ss;
+  writeStringTree(ss, t, ruleNames);
+  return ss.str();
+}
+
+namespace {
+
+  // Calls enter for each node in pre-order and exit for each node with children after its subtree.
+  // Implements the recursive walk as iteration to avoid trouble with deep nesting.
+  template<typename Enter, typename Exit>
+  void walkTree(ParseTree *t, Enter enter, Exit exit) {
+    std::vector<std::pair<ParseTree *, size_t>> stack;
+    enter(t, 0);
+    if (t->children.empty()) {
+      return;
+    }
+
+    stack.push_back({ t, 0 });
+    while (!stack.empty()) {
+      ParseTree *run = stack.back().first;
+      size_t childIndex = stack.back().second;
+      if (childIndex == run->children.size()) {
+        stack.pop_back();
+        exit(run);
+        continue;
+      }
+      ++stack.back().second;
+
+      ParseTree *child = run->children[childIndex];
+      enter(child, childIndex);
+      if (!child->children.empty()) {
+        stack.push_back({ child, 0 });
+      }
+    }
   }
 
-  std::stringstream ss;
-  ss << "(" << temp << ' ';
-
-  // Implement the recursive walk as iteration to avoid trouble with deep nesting.
-  std::stack<size_t> stack;
-  size_t childIndex = 0;
-  ParseTree *run = t;
-  while (childIndex < run->children.size()) {
-    if (childIndex > 0) {
-      ss << ' ';
-    }
-    ParseTree *child = run->children[childIndex];
-    temp = antlrcpp::escapeWhitespace(Trees::getNodeText(child, ruleNames), false);
-    if (!child->children.empty()) {
-      // Go deeper one level.
-      stack.push(childIndex);
-      run = child;
-      childIndex = 0;
-      ss << "(" << temp << " ";
-    } else {
-      ss << temp;
-      while (++childIndex == run->children.size()) {
-        if (stack.size() > 0) {
-          // Reached the end of the current level. See if we can step up from here.
-          childIndex = stack.top();
-          stack.pop();
-          run = run->parent;
-          ss << ")";
-        } else {
+  // Same as out << antlrcpp::escapeWhitespace(text, false), but without a copy of the text.
+  void writeEscaped(std::ostream &out, const std::string &text) {
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+      const char *replacement;
+      switch (text[i]) {
+        case '\n':
+          replacement = "\\n";
           break;
-        }
+        case '\r':
+          replacement = "\\r";
+          break;
+        case '\t':
+          replacement = "\\t";
+          break;
+        default:
+          continue;
       }
+      out.write(text.data() + start, static_cast<std::streamsize>(i - start));
+      out << replacement;
+      start = i + 1;
     }
+    out.write(text.data() + start, static_cast<std::streamsize>(text.size() - start));
   }
 
-  ss << ")";
-  return ss.str();
+  void writeJSONString(std::ostream &out, const std::string &text) {
+    static const char hexDigits[] = "0123456789abcdef";
+
+    out << '"';
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+      unsigned char c = static_cast<unsigned char>(text[i]);
+      if (c >= 0x20 && c != '"' && c != '\\') {
+        continue;
+      }
+      out.write(text.data() + start, static_cast<std::streamsize>(i - start));
+      switch (c) {
+        case '"':
+          out << "\\\"";
+          break;
+        case '\\':
+          out << "\\\\";
+          break;
+        case '\n':
+          out << "\\n";
+          break;
+        case '\r':
+          out << "\\r";
+          break;
+        case '\t':
+          out << "\\t";
+          break;
+        default:
+          out << "\\u00" << hexDigits[c >> 4] << hexDigits[c & 0xF];
+          break;
+      }
+      start = i + 1;
+    }
+    out.write(text.data() + start, static_cast<std::streamsize>(text.size() - start));
+    out << '"';
+  }
+
+  void writeVarint(std::ostream &out, size_t value) {
+    char buffer[10];
+    size_t length = 0;
+    while (value >= 0x80) {
+      buffer[length++] = static_cast<char>((value & 0x7F) | 0x80);
+      value >>= 7;
+    }
+    buffer[length++] = static_cast<char>(value);
+    out.write(buffer, static_cast<std::streamsize>(length));
+  }
+
+}
+
+void Trees::writeStringTree(std::ostream &out, ParseTree *t, const std::vector<std::string> &ruleNames) {
+  walkTree(t, [&](ParseTree *node, size_t childIndex) {
+    if (node != t && childIndex > 0) {
+      out << ' ';
+    }
+    if (!node->children.empty()) {
+      out << '(';
+    }
+
+    if (!ruleNames.empty() && node->getTreeType() == ParseTreeType::RULE) {
+      // Avoid the string copy of getNodeText() for the common case.
+      RuleContext *ctx = static_cast<RuleContext *>(node);
+      writeEscaped(out, ruleNames[ctx->getRuleIndex()]);
+      size_t altNumber = ctx->getAltNumber();
+      if (altNumber != atn::ATN::INVALID_ALT_NUMBER) {
+        out << ':' << altNumber;
+      }
+    } else {
+      writeEscaped(out, getNodeText(node, ruleNames));
+    }
+
+    if (!node->children.empty()) {
+      out << ' ';
+    }
+  }, [&](ParseTree * /*node*/) {
+    out << ')';
+  });
+}
+
+void Trees::writeJSONTree(std::ostream &out, ParseTree *t, const std::vector<std::string> &ruleNames) {
+  walkTree(t, [&](ParseTree *node, size_t childIndex) {
+    if (node != t && childIndex > 0) {
+      out << ',';
+    }
+
+    if (node->getTreeType() == ParseTreeType::RULE) {
+      RuleContext *ctx = static_cast<RuleContext *>(node);
+      size_t ruleIndex = ctx->getRuleIndex();
+      out << "{\"rule\":";
+      if (ruleIndex < ruleNames.size()) {
+        writeJSONString(out, ruleNames[ruleIndex]);
+      } else {
+        out << ruleIndex;
+      }
+      size_t altNumber = ctx->getAltNumber();
+      if (altNumber != atn::ATN::INVALID_ALT_NUMBER) {
+        out << ",\"alt\":" << altNumber;
+      }
+    } else {
+      Token *symbol = static_cast<TerminalNode *>(node)->getSymbol();
+      out << "{\"type\":";
+      if (symbol->getType() == Token::EOF) {
+        out << "-1";
+      } else {
+        out << symbol->getType();
+      }
+      out << ",\"index\":";
+      if (symbol->getTokenIndex() == INVALID_INDEX) {
+        out << "-1";
+      } else {
+        out << symbol->getTokenIndex();
+      }
+      out << ",\"text\":";
+      writeJSONString(out, symbol->getText());
+      if (node->getTreeType() == ParseTreeType::ERROR) {
+        out << ",\"error\":true";
+      }
+    }
+
+    if (node->children.empty()) {
+      out << '}';
+    } else {
+      out << ",\"children\":[";
+    }
+  }, [&](ParseTree * /*node*/) {
+    out << "]}";
+  });
+}
+
+void Trees::writeBinaryTree(std::ostream &out, ParseTree *t) {
+  walkTree(t, [&](ParseTree *node, size_t /*childIndex*/) {
+    out.put(static_cast<char>(node->getTreeType()));
+    if (node->getTreeType() == ParseTreeType::RULE) {
+      RuleContext *ctx = static_cast<RuleContext *>(node);
+      writeVarint(out, ctx->getRuleIndex());
+      writeVarint(out, ctx->getAltNumber());
+      writeVarint(out, node->children.size());
+    } else {
+      Token *symbol = static_cast<TerminalNode *>(node)->getSymbol();
+      writeVarint(out, symbol->getType() + 1); // EOF becomes 0.
+      writeVarint(out, symbol->getTokenIndex() + 1); // INVALID_INDEX becomes 0.
+      std::string text = symbol->getText();
+      writeVarint(out, text.size());
+      out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+  }, [](ParseTree * /*node*/) {
+  });
 }
 
 std::string Trees::getNodeText(ParseTree *t, Parser *recog) {
@@ -86,27 +253,33 @@ std::string Trees::getNodeText(ParseTree *t, Parser *recog) {
 
 std::string Trees::getNodeText(ParseTree *t, const std::vector<std::string> &ruleNames) {
   if (ruleNames.size() > 0) {
-    if (is<RuleContext *>(t)) {
-      size_t ruleIndex = dynamic_cast<RuleContext *>(t)->getRuleIndex();
-      std::string ruleName = ruleNames[ruleIndex];
-      size_t altNumber = dynamic_cast<RuleContext *>(t)->getAltNumber();
-      if (altNumber != atn::ATN::INVALID_ALT_NUMBER) {
-        return ruleName + ":" + std::to_string(altNumber);
+    switch (t->getTreeType()) {
+      case ParseTreeType::RULE: {
+        RuleContext *ctx = static_cast<RuleContext *>(t);
+        std::string ruleName = ruleNames[ctx->getRuleIndex()];
+        size_t altNumber = ctx->getAltNumber();
+        if (altNumber != atn::ATN::INVALID_ALT_NUMBER) {
+          return ruleName + ":" + std::to_string(altNumber);
+        }
+        return ruleName;
       }
-      return ruleName;
-    } else if (is<ErrorNode *>(t)) {
-      return t->toString();
-    } else if (is<TerminalNode *>(t)) {
-      Token *symbol = dynamic_cast<TerminalNode *>(t)->getSymbol();
-      if (symbol != nullptr) {
-        std::string s = symbol->getText();
-        return s;
+
+      case ParseTreeType::ERROR:
+        return t->toString();
+
+      case ParseTreeType::TERMINAL: {
+        Token *symbol = static_cast<TerminalNode *>(t)->getSymbol();
+        if (symbol != nullptr) {
+          std::string s = symbol->getText();
+          return s;
+        }
+        break;
       }
     }
   }
   // no recog for rule names
-  if (is<RuleContext *>(t)) {
-    return dynamic_cast<RuleContext *>(t)->getText();
+  if (t->getTreeType() == ParseTreeType::RULE) {
+    return static_cast<RuleContext *>(t)->getText();
   }
 
   if (is<TerminalNodeImpl *>(t)) {
@@ -126,26 +299,6 @@ std::vector<ParseTree *> Trees::getAncestors(ParseTree *t) {
   return ancestors;
 }
 
-template<typename T>
-static void _findAllNodes(ParseTree *t, size_t index, bool findTokens, std::vector<T> &nodes) {
-  // check this node (the root) first
-  if (findTokens && is<TerminalNode *>(t)) {
-    TerminalNode *tnode = dynamic_cast<TerminalNode *>(t);
-    if (tnode->getSymbol()->getType() == index) {
-      nodes.push_back(t);
-    }
-  } else if (!findTokens && is<ParserRuleContext *>(t)) {
-    ParserRuleContext *ctx = dynamic_cast<ParserRuleContext *>(t);
-    if (ctx->getRuleIndex() == index) {
-      nodes.push_back(t);
-    }
-  }
-  // check children
-  for (size_t i = 0; i < t->children.size(); i++) {
-    _findAllNodes(t->children[i], index, findTokens, nodes);
-  }
-}
-
 bool Trees::isAncestorOf(ParseTree *t, ParseTree *u) {
   if (t == nullptr || u == nullptr || t->parent == nullptr) {
     return false;
@@ -170,22 +323,12 @@ std::vector<ParseTree *> Trees::findAllRuleNodes(ParseTree *t, size_t ruleIndex)
 }
 
 std::vector<ParseTree *> Trees::findAllNodes(ParseTree *t, size_t index, bool findTokens) {
-  std::vector<ParseTree *> nodes;
-  _findAllNodes<ParseTree *>(t, index, findTokens, nodes);
-  return nodes;
+  ParseTreeRange range(t);
+  return findTokens ? range.tokens(index).toVector() : range.rules(index).toVector();
 }
 
 std::vector<ParseTree *> Trees::getDescendants(ParseTree *t) {
-  std::vector<ParseTree *> nodes;
-  nodes.push_back(t);
-  std::size_t n = t->children.size();
-  for (size_t i = 0 ; i < n ; i++) {
-    auto descentants = getDescendants(t->children[i]);
-    for (auto entry: descentants) {
-      nodes.push_back(entry);
-    }
-  }
-  return nodes;
+  return ParseTreeRange(t).toVector();
 }
 
 std::vector<ParseTree *> Trees::descendants(ParseTree *t) {
@@ -193,17 +336,9 @@ std::vector<ParseTree *> Trees::descendants(ParseTree *t) {
 }
 
 ParserRuleContext* Trees::getRootOfSubtreeEnclosingRegion(ParseTree *t, size_t startTokenIndex, size_t stopTokenIndex) {
-  size_t n = t->children.size();
-  for (size_t i = 0; i < n; i++) {
-    ParserRuleContext *r = getRootOfSubtreeEnclosingRegion(t->children[i], startTokenIndex, stopTokenIndex);
-    if (r != nullptr) {
-      return r;
-    }
-  }
-
-  if (is<ParserRuleContext *>(t)) {
-    ParserRuleContext *r = dynamic_cast<ParserRuleContext *>(t);
-    if (startTokenIndex >= r->getStart()->getTokenIndex() && // is range fully contained in t?
+  for (ParseTree *node : ParseTreeRange(t, TraversalOrder::POST_ORDER).rules()) {
+    ParserRuleContext *r = dynamic_cast<ParserRuleContext *>(node);
+    if (r != nullptr && startTokenIndex >= r->getStart()->getTokenIndex() && // is range fully contained in t?
         (r->getStop() == nullptr || stopTokenIndex <= r->getStop()->getTokenIndex())) {
       // note: r.getStop()==null likely implies that we bailed out of parser and there's nothing to the right
       return r;
@@ -213,18 +348,6 @@ ParserRuleContext* Trees::getRootOfSubtreeEnclosingRegion(ParseTree *t, size_t s
 }
 
 ParseTree * Trees::findNodeSuchThat(ParseTree *t, Ref<Predicate> const& pred) {
-  if (pred->test(t)) {
-    return t;
-  }
-
-  size_t n = t->children.size();
-  for (size_t i = 0 ; i < n ; ++i) {
-    ParseTree *u = findNodeSuchThat(t->children[i], pred);
-    if (u != nullptr) {
-      return u;
-    }
-  }
-
-  return nullptr;
+  return ParseTreeRange(t).filter([&pred](ParseTree *node) { return pred->test(node); }).first();
 }
 
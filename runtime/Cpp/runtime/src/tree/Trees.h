@@ -13,6 +13,8 @@ namespace antlr4 {
 namespace tree {
 
   /// A set of utility routines useful for all kinds of ANTLR trees.
+  /// The functions returning lists of nodes are built on ParseTreeRange, which can also be used directly
+  /// to visit matching nodes one by one, without collecting them first.
   class ANTLR4CPP_PUBLIC Trees {
   public:
     /// Print out a whole tree in LISP form. getNodeText is used on the
@@ -29,6 +31,26 @@ namespace tree {
     /// node payloads to get the text for the nodes.  Detect
     /// parse trees and extract data appropriately.
     static std::string toStringTree(ParseTree *t, const std::vector<std::string> &ruleNames);
+
+    /// Writes the tree in LISP form (the same text as toStringTree()) directly to the stream.
+    /// All writer functions walk the tree iteratively and don't build any intermediate strings beyond
+    /// the text of single tokens, so they can be used for very large and deeply nested trees.
+    static void writeStringTree(std::ostream &out, ParseTree *t, const std::vector<std::string> &ruleNames);
+
+    /// Writes the tree as JSON. A rule node is written as {"rule":"name","alt":n,"children":[...]}, where
+    /// "rule" is the rule index if no rule names are given, "alt" is only present for a valid alt number and
+    /// "children" only for a non-empty node. A token is written as {"type":n,"index":n,"text":"..."}, with
+    /// an additional "error":true for error nodes. Type and index are -1 for EOF and conjured tokens.
+    static void writeJSONTree(std::ostream &out, ParseTree *t, const std::vector<std::string> &ruleNames);
+
+    /// Writes the tree in a compact binary form, in pre-order. All numbers are unsigned LEB128 varints.
+    /// Each node starts with a byte for its ParseTreeType (1 = terminal, 2 = error, 3 = rule).
+    /// A rule node continues with its rule index, alt number and the number of children, followed by the
+    /// children. A terminal or error node continues with token type + 1 (0 for EOF), token index + 1
+    /// (0 for none) and the length of the token text in bytes, followed by the UTF-8 text.
+    /// The stream should be opened in binary mode.
+    static void writeBinaryTree(std::ostream &out, ParseTree *t);
+
     static std::string getNodeText(ParseTree *t, Parser *recog);
     static std::string getNodeText(ParseTree *t, const std::vector<std::string> &ruleNames);
 
@@ -0,0 +1,92 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "tree/ErrorNode.h"
+#include "tree/ParseTree.h"
+#include "tree/ParseTreeDispatcher.h"
+#include "tree/TerminalNode.h"
+
+namespace antlr4 {
+namespace tree {
+
+  /// The counterpart of AbstractParseTreeVisitor whose result type T is fixed at compile time. Results are
+  /// returned and aggregated by value and moved wherever possible, without the heap allocation, copying
+  /// and type checks antlrcpp::Any needs. T must be move constructible and move assignable, and default
+  /// constructible unless defaultResult() is overridden.
+  ///
+  /// Visitors for a specific grammar X derive from the generated XTypedVisitor<T>, which passes its
+  /// XDispatcher as the Dispatcher base class.
+  template<typename T, typename Dispatcher = ParseTreeDispatcher>
+  class TypedParseTreeVisitor : public Dispatcher {
+  public:
+    typedef T ResultType;
+
+    virtual T visit(ParseTree *tree) {
+      switch (tree->getTreeType()) {
+        case ParseTreeType::TERMINAL:
+          return visitTerminal(static_cast<TerminalNode *>(tree));
+        case ParseTreeType::ERROR:
+          return visitErrorNode(dynamic_cast<ErrorNode *>(tree));
+        default:
+          break;
+      }
+
+      DispatchResult<T> result;
+      tree->dispatch(this, &result);
+      return result.take();
+    }
+
+    /// Visits the children in order, like AbstractParseTreeVisitor::visitChildren.
+    virtual T visitChildren(ParseTree *node) {
+      T result = defaultResult();
+      size_t n = node->children.size();
+      for (size_t i = 0; i < n; i++) {
+        if (!shouldVisitNextChild(node, result)) {
+          break;
+        }
+
+        result = aggregateResult(std::move(result), visit(node->children[i]));
+      }
+
+      return result;
+    }
+
+    virtual T visitTerminal(TerminalNode * /*node*/) {
+      return defaultResult();
+    }
+
+    virtual T visitErrorNode(ErrorNode * /*node*/) {
+      return defaultResult();
+    }
+
+  protected:
+    virtual T defaultResult() {
+      return T();
+    }
+
+    /// Both values are passed by value, so an implementation can move from them.
+    /// The default implementation returns nextResult.
+    virtual T aggregateResult(T /*aggregate*/, T nextResult) {
+      return nextResult;
+    }
+
+    virtual bool shouldVisitNextChild(ParseTree * /*node*/, const T &/*currentResult*/) {
+      return true;
+    }
+
+    virtual void dispatchChildren(ParseTree *node, void *result) override {
+      storeResult(result, visitChildren(node));
+    }
+
+    /// For the dispatch methods: stores the result of a visit method in the result passed to dispatch.
+    static void storeResult(void *result, T &&value) {
+      static_cast<DispatchResult<T> *>(result)->set(std::move(value));
+    }
+  };
+
+} // namespace tree
+} // namespace antlr4
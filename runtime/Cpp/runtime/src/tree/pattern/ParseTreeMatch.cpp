@@ -19,6 +19,13 @@ ParseTreeMatch::ParseTreeMatch(ParseTree *tree, const ParseTreePattern &pattern,
   }
 }
 
+ParseTreeMatch::ParseTreeMatch(ParseTree *tree, const Ref<const ParseTreePattern> &pattern,
+                               const std::map<std::string, std::vector<ParseTree *>> &labels,
+                               ParseTree *mismatchedNode)
+  : ParseTreeMatch(tree, *pattern, labels, mismatchedNode) {
+  _sharedPattern = pattern;
+}
+
 ParseTreeMatch::~ParseTreeMatch() {
 }
 
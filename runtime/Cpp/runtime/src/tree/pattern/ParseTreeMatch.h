@@ -20,6 +20,9 @@ namespace pattern {
     /// This is the backing field for getPattern().
     const ParseTreePattern &_pattern;
 
+    /// Keeps the pattern alive if it is shared with a cache (see ParseTreePatternMatcher::match()).
+    Ref<const ParseTreePattern> _sharedPattern;
+
     /// This is the backing field for getLabels().
     std::map<std::string, std::vector<ParseTree *>> _labels;
 
@@ -43,6 +46,10 @@ namespace pattern {
     /// <exception cref="IllegalArgumentException"> if {@code labels} is {@code null} </exception>
     ParseTreeMatch(ParseTree *tree, ParseTreePattern const& pattern,
                    const std::map<std::string, std::vector<ParseTree *>> &labels, ParseTree *mismatchedNode);
+
+    /// Same as above, but the match shares the ownership of the pattern.
+    ParseTreeMatch(ParseTree *tree, const Ref<const ParseTreePattern> &pattern,
+                   const std::map<std::string, std::vector<ParseTree *>> &labels, ParseTree *mismatchedNode);
     ParseTreeMatch(ParseTreeMatch const&) = default;
     virtual ~ParseTreeMatch();
     ParseTreeMatch& operator=(ParseTreeMatch const&) = default;
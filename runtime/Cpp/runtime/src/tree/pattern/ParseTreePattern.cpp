@@ -8,7 +8,6 @@
 #include "tree/pattern/ParseTreeMatch.h"
 
 #include "tree/xpath/XPath.h"
-#include "tree/xpath/XPathElement.h"
 
 #include "tree/pattern/ParseTreePattern.h"
 
@@ -18,8 +17,9 @@ using namespace antlr4::tree::pattern;
 using namespace antlrcpp;
 
 ParseTreePattern::ParseTreePattern(ParseTreePatternMatcher *matcher, const std::string &pattern, int patternRuleIndex_,
-                                   ParseTree *patternTree)
-  : patternRuleIndex(patternRuleIndex_), _pattern(pattern), _patternTree(patternTree), _matcher(matcher) {
+                                   ParseTree *patternTree, std::shared_ptr<void> patternStorage)
+  : patternRuleIndex(patternRuleIndex_), _pattern(pattern), _patternTree(patternTree), _matcher(matcher),
+    _patternStorage(std::move(patternStorage)) {
 }
 
 ParseTreePattern::~ParseTreePattern() {
@@ -26,8 +26,10 @@ namespace pattern {
     /// <param name="patternRuleIndex"> The parser rule which serves as the root of the
     /// tree pattern. </param>
     /// <param name="patternTree"> The tree pattern in <seealso cref="ParseTree"/> form. </param>
+    /// <param name="patternStorage"> Owns the nodes and tokens of the pattern tree, if they are not owned
+    /// elsewhere. It is shared by all copies of this pattern. </param>
     ParseTreePattern(ParseTreePatternMatcher *matcher, const std::string &pattern, int patternRuleIndex,
-                     ParseTree *patternTree);
+                     ParseTree *patternTree, std::shared_ptr<void> patternStorage = nullptr);
     ParseTreePattern(ParseTreePattern const&) = default;
     virtual ~ParseTreePattern();
     ParseTreePattern& operator=(ParseTreePattern const&) = default;
@@ -99,6 +101,9 @@ namespace pattern {
 
     /// This is the backing field for <seealso cref="#getMatcher()"/>.
     ParseTreePatternMatcher *const _matcher;
+
+    /// Keeps the pattern tree alive.
+    std::shared_ptr<void> _patternStorage;
   };
 
 } // namespace pattern
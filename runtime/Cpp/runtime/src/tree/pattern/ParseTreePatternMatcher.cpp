@@ -17,6 +17,7 @@
 #include "BailErrorStrategy.h"
 
 #include "ListTokenSource.h"
+#include "WritableToken.h"
 #include "tree/pattern/TextChunk.h"
 #include "ANTLRInputStream.h"
 #include "support/Arrays.h"
@@ -31,6 +32,21 @@ using namespace antlr4::tree;
 using namespace antlr4::tree::pattern;
 using namespace antlrcpp;
 
+namespace {
+
+  // Owns everything a compiled pattern tree refers to.
+  struct PatternStorage {
+    ListTokenSource tokenSource;
+    CommonTokenStream tokens;
+    ParseTreeTracker nodes;
+
+    PatternStorage(std::vector<std::unique_ptr<Token>> patternTokens)
+      : tokenSource(std::move(patternTokens)), tokens(&tokenSource) {
+    }
+  };
+
+}
+
 ParseTreePatternMatcher::CannotInvokeStartRule::CannotInvokeStartRule(const RuntimeException &e) : RuntimeException(e.what()) {
 }
 
@@ -59,11 +75,11 @@ void ParseTreePatternMatcher::setDelimiters(const std::string &start, const std:
  _start = start;
   _stop = stop;
   _escape = escapeLeft;
+  _compiledPatterns.clear();
 }
 
 bool ParseTreePatternMatcher::matches(ParseTree *tree, const std::string &pattern, int patternRuleIndex) {
-  ParseTreePattern p = compile(pattern, patternRuleIndex);
-  return matches(tree, p);
+  return matches(tree, *getCompiledPattern(pattern, patternRuleIndex));
 }
 
 bool ParseTreePatternMatcher::matches(ParseTree *tree, const ParseTreePattern &pattern) {
@@ -73,8 +89,11 @@ bool ParseTreePatternMatcher::matches(ParseTree *tree, const ParseTreePattern &p
 }
 
 ParseTreeMatch ParseTreePatternMatcher::match(ParseTree *tree, const std::string &pattern, int patternRuleIndex) {
-  ParseTreePattern p = compile(pattern, patternRuleIndex);
-  return match(tree, p);
+  // The match refers to the pattern, so it shares the ownership of it.
+  Ref<const ParseTreePattern> compiled = getCompiledPattern(pattern, patternRuleIndex);
+  std::map<std::string, std::vector<ParseTree *>> labels;
+  tree::ParseTree *mismatchedNode = matchImpl(tree, compiled->getPatternTree(), labels);
+  return ParseTreeMatch(tree, compiled, labels, mismatchedNode);
 }
 
 ParseTreeMatch ParseTreePatternMatcher::match(ParseTree *tree, const ParseTreePattern &pattern) {
@@ -84,8 +103,9 @@ ParseTreeMatch ParseTreePatternMatcher::match(ParseTree *tree, const ParseTreePa
 }
 
 ParseTreePattern ParseTreePatternMatcher::compile(const std::string &pattern, int patternRuleIndex) {
-  ListTokenSource tokenSrc(tokenize(pattern));
-  CommonTokenStream tokens(&tokenSrc);
+  // The pattern tree refers to its tokens, so they are kept together with its nodes.
+  std::shared_ptr<PatternStorage> storage = std::make_shared<PatternStorage>(tokenize(pattern));
+  CommonTokenStream &tokens = storage->tokens;
 
   ParserInterpreter parserInterp(_parser->getGrammarFileName(), _parser->getVocabulary(),
                                  _parser->getRuleNames(), _parser->getATNWithBypassAlts(), &tokens);
@@ -118,7 +138,37 @@ ParseTreePattern ParseTreePatternMatcher::compile(const std::string &pattern, in
     throw StartRuleDoesNotConsumeFullPattern();
   }
 
-  return ParseTreePattern(this, pattern, patternRuleIndex, tree);
+  storage->nodes.adopt(parserInterp.getTreeTracker());
+  return ParseTreePattern(this, pattern, patternRuleIndex, tree, storage);
+}
+
+Ref<const ParseTreePattern> ParseTreePatternMatcher::getCompiledPattern(const std::string &pattern,
+                                                                        int patternRuleIndex) {
+  if (_maxCompiledPatterns == 0) {
+    return std::make_shared<ParseTreePattern>(compile(pattern, patternRuleIndex));
+  }
+
+  auto key = std::make_pair(pattern, patternRuleIndex);
+  auto iterator = _compiledPatterns.find(key);
+  if (iterator == _compiledPatterns.end()) {
+    Ref<const ParseTreePattern> compiled = std::make_shared<ParseTreePattern>(compile(pattern, patternRuleIndex));
+    if (_compiledPatterns.size() >= _maxCompiledPatterns) {
+      _compiledPatterns.clear();
+    }
+    iterator = _compiledPatterns.emplace(key, compiled).first;
+  }
+  return iterator->second;
+}
+
+void ParseTreePatternMatcher::setMaxCompiledPatterns(size_t maxCount) {
+  _maxCompiledPatterns = maxCount;
+  if (_compiledPatterns.size() > _maxCompiledPatterns) {
+    _compiledPatterns.clear();
+  }
+}
+
+size_t ParseTreePatternMatcher::getMaxCompiledPatterns() const {
+  return _maxCompiledPatterns;
 }
 
 Lexer* ParseTreePatternMatcher::getLexer() {
@@ -140,13 +190,13 @@ ParseTree* ParseTreePatternMatcher::matchImpl(ParseTree *tree, ParseTree *patter
   }
 
   // x and <ID>, x and y, or x and x; or could be mismatched types
-  if (is<TerminalNode *>(tree) && is<TerminalNode *>(patternTree)) {
-    TerminalNode *t1 = dynamic_cast<TerminalNode *>(tree);
-    TerminalNode *t2 = dynamic_cast<TerminalNode *>(patternTree);
+  if (tree->getTreeType() != ParseTreeType::RULE && patternTree->getTreeType() != ParseTreeType::RULE) {
+    TerminalNode *t1 = static_cast<TerminalNode *>(tree);
+    TerminalNode *t2 = static_cast<TerminalNode *>(patternTree);
 
     ParseTree *mismatchedNode = nullptr;
     // both are tokens and they have same type
-    if (t1->getSymbol()->getType() == t2->getSymbol()->getType()) {
+    if (t1->getRuleIndexOrTokenType() == t2->getRuleIndexOrTokenType()) {
       if (is<TokenTagToken *>(t2->getSymbol())) { // x and <ID>
         TokenTagToken *tokenTagToken = dynamic_cast<TokenTagToken *>(t2->getSymbol());
 
@@ -181,7 +231,7 @@ ParseTree* ParseTreePatternMatcher::matchImpl(ParseTree *tree, ParseTree *patter
     RuleTagToken *ruleTagToken = getRuleTagToken(r2);
     if (ruleTagToken != nullptr) {
       //ParseTreeMatch *m = nullptr; // unused?
-      if (r1->getRuleIndex() == r2->getRuleIndex()) {
+      if (r1->getRuleIndexOrTokenType() == r2->getRuleIndexOrTokenType()) {
         // track label->list-of-nodes for both rule name and label (if any)
         labels[ruleTagToken->getRuleName()].push_back(tree);
         if (ruleTagToken->getLabel() != "") {
@@ -221,8 +271,8 @@ ParseTree* ParseTreePatternMatcher::matchImpl(ParseTree *tree, ParseTree *patter
 }
 
 RuleTagToken* ParseTreePatternMatcher::getRuleTagToken(ParseTree *t) {
-  if (t->children.size() == 1 && is<TerminalNode *>(t->children[0])) {
-    TerminalNode *c = dynamic_cast<TerminalNode *>(t->children[0]);
+  if (t->children.size() == 1 && t->children[0]->getTreeType() != ParseTreeType::RULE) {
+    TerminalNode *c = static_cast<TerminalNode *>(t->children[0]);
     if (is<RuleTagToken *>(c->getSymbol())) {
       return dynamic_cast<RuleTagToken *>(c->getSymbol());
     }
@@ -232,13 +282,13 @@ RuleTagToken* ParseTreePatternMatcher::getRuleTagToken(ParseTree *t) {
 
 std::vector<std::unique_ptr<Token>> ParseTreePatternMatcher::tokenize(const std::string &pattern) {
   // split pattern into chunks: sea (raw input) and islands (<ID>, <expr>)
-  std::vector<Chunk> chunks = split(pattern);
+  std::vector<std::unique_ptr<Chunk>> chunks = split(pattern);
 
   // create token stream from text and tags
   std::vector<std::unique_ptr<Token>> tokens;
-  for (auto chunk : chunks) {
-    if (is<TagChunk *>(&chunk)) {
-      TagChunk &tagChunk = (TagChunk&)chunk;
+  for (auto &chunk : chunks) {
+    if (is<TagChunk *>(chunk.get())) {
+      TagChunk &tagChunk = static_cast<TagChunk&>(*chunk);
       // add special rule token or conjure up new token from name
       if (isupper(tagChunk.getTag()[0])) {
         size_t ttype = _parser->getTokenType(tagChunk.getTag());
@@ -257,11 +307,16 @@ std::vector<std::unique_ptr<Token>> ParseTreePatternMatcher::tokenize(const std:
         throw IllegalArgumentException("invalid tag: " + tagChunk.getTag() + " in pattern: " + pattern);
       }
     } else {
-      TextChunk &textChunk = (TextChunk&)chunk;
+      TextChunk &textChunk = static_cast<TextChunk&>(*chunk);
       ANTLRInputStream input(textChunk.getText());
       _lexer->setInputStream(&input);
       std::unique_ptr<Token> t(_lexer->nextToken());
       while (t->getType() != Token::EOF) {
+        // The token text is taken from the input, which is gone after this loop.
+        WritableToken *writable = dynamic_cast<WritableToken *>(t.get());
+        if (writable != nullptr) {
+          writable->setText(t->getText());
+        }
         tokens.push_back(std::move(t));
         t = _lexer->nextToken();
       }
@@ -272,10 +327,10 @@ std::vector<std::unique_ptr<Token>> ParseTreePatternMatcher::tokenize(const std:
   return tokens;
 }
 
-std::vector<Chunk> ParseTreePatternMatcher::split(const std::string &pattern) {
+std::vector<std::unique_ptr<Chunk>> ParseTreePatternMatcher::split(const std::string &pattern) {
   size_t p = 0;
   size_t n = pattern.length();
-  std::vector<Chunk> chunks;
+  std::vector<std::unique_ptr<Chunk>> chunks;
 
   // find all start and stop indexes first, then collect
   std::vector<size_t> starts;
@@ -314,12 +369,12 @@ std::vector<Chunk> ParseTreePatternMatcher::split(const std::string &pattern) {
   // collect into chunks now
   if (ntags == 0) {
     std::string text = pattern.substr(0, n);
-    chunks.push_back(TextChunk(text));
+    chunks.emplace_back(new TextChunk(text));
   }
 
   if (ntags > 0 && starts[0] > 0) { // copy text up to first tag into chunks
     std::string text = pattern.substr(0, starts[0]);
-    chunks.push_back(TextChunk(text));
+    chunks.emplace_back(new TextChunk(text));
   }
 
   for (size_t i = 0; i < ntags; i++) {
@@ -332,11 +387,11 @@ std::vector<Chunk> ParseTreePatternMatcher::split(const std::string &pattern) {
       label = tag.substr(0,colon);
       ruleOrToken = tag.substr(colon + 1, tag.length() - (colon + 1));
     }
-    chunks.push_back(TagChunk(label, ruleOrToken));
+    chunks.emplace_back(new TagChunk(label, ruleOrToken));
     if (i + 1 < ntags) {
       // copy from end of <tag> to start of next
       std::string text = pattern.substr(stops[i] + _stop.length(), starts[i + 1] - (stops[i] + _stop.length()));
-      chunks.push_back(TextChunk(text));
+      chunks.emplace_back(new TextChunk(text));
     }
   }
 
@@ -344,19 +399,18 @@ std::vector<Chunk> ParseTreePatternMatcher::split(const std::string &pattern) {
     size_t afterLastTag = stops[ntags - 1] + _stop.length();
     if (afterLastTag < n) { // copy text from end of last tag to end
       std::string text = pattern.substr(afterLastTag, n - afterLastTag);
-      chunks.push_back(TextChunk(text));
+      chunks.emplace_back(new TextChunk(text));
     }
   }
 
   // strip out all backslashes from text chunks but not tags
   for (size_t i = 0; i < chunks.size(); i++) {
-    Chunk &c = chunks[i];
-    if (is<TextChunk *>(&c)) {
-      TextChunk &tc = (TextChunk&)c;
+    if (is<TextChunk *>(chunks[i].get())) {
+      TextChunk &tc = static_cast<TextChunk&>(*chunks[i]);
       std::string unescaped = tc.getText();
       unescaped.erase(std::remove(unescaped.begin(), unescaped.end(), '\\'), unescaped.end());
       if (unescaped.length() < tc.getText().length()) {
-        chunks[i] = TextChunk(unescaped);
+        chunks[i].reset(new TextChunk(unescaped));
       }
     }
   }
@@ -368,4 +422,5 @@ void ParseTreePatternMatcher::InitializeInstanceFields() {
   _start = "<";
   _stop = ">";
   _escape = "\\";
+  _maxCompiledPatterns = DEFAULT_MAX_COMPILED_PATTERNS;
 }
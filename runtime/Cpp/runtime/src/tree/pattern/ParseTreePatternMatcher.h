@@ -6,6 +6,7 @@
 #pragma once
 
 #include "Exceptions.h"
+#include "tree/pattern/ParseTreePattern.h"
 
 namespace antlr4 {
 namespace tree {
@@ -87,6 +88,9 @@ namespace pattern {
       StartRuleDoesNotConsumeFullPattern& operator=(StartRuleDoesNotConsumeFullPattern const&) = default;
     };
 
+    /// The default for setMaxCompiledPatterns().
+    static const size_t DEFAULT_MAX_COMPILED_PATTERNS = 256;
+
     /// Constructs a <seealso cref="ParseTreePatternMatcher"/> or from a <seealso cref="Lexer"/> and
     /// <seealso cref="Parser"/> object. The lexer input stream is altered for tokenizing
     /// the tree patterns. The parser is used as a convenient mechanism to get
@@ -104,6 +108,9 @@ namespace pattern {
     /// </param>
     /// <exception cref="IllegalArgumentException"> if {@code start} is {@code null} or empty. </exception>
     /// <exception cref="IllegalArgumentException"> if {@code stop} is {@code null} or empty. </exception>
+    ///
+    /// This clears the compiled patterns kept by the matcher. Matches returned before stay valid, as they share
+    /// the ownership of their pattern.
     virtual void setDelimiters(const std::string &start, const std::string &stop, const std::string &escapeLeft);
 
     /// <summary>
@@ -137,6 +144,15 @@ namespace pattern {
     /// </summary>
     virtual ParseTreePattern compile(const std::string &pattern, int patternRuleIndex);
 
+    /// Returns the compiled form of the pattern, which is compiled on first use and then kept by this matcher
+    /// (until the delimiters are changed or the cache is full). The string based match methods use this cache.
+    virtual Ref<const ParseTreePattern> getCompiledPattern(const std::string &pattern, int patternRuleIndex);
+
+    /// The number of compiled patterns kept by the matcher. They are all dropped when the limit is reached,
+    /// a limit of 0 disables the cache.
+    void setMaxCompiledPatterns(size_t maxCount);
+    size_t getMaxCompiledPatterns() const;
+
     /// <summary>
     /// Used to convert the tree pattern string into a series of tokens. The
     /// input stream is reset.
@@ -154,7 +170,7 @@ namespace pattern {
     virtual std::vector<std::unique_ptr<Token>> tokenize(const std::string &pattern);
 
     /// Split "<ID> = <e:expr>;" into 4 chunks for tokenizing by tokenize().
-    virtual std::vector<Chunk> split(const std::string &pattern);
+    virtual std::vector<std::unique_ptr<Chunk>> split(const std::string &pattern);
 
   protected:
     std::string _start;
@@ -177,6 +193,9 @@ namespace pattern {
     Lexer *_lexer;
     Parser *_parser;
 
+    std::map<std::pair<std::string, int>, Ref<const ParseTreePattern>> _compiledPatterns;
+    size_t _maxCompiledPatterns;
+
     void InitializeInstanceFields();
   };
 
@@ -0,0 +1,89 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "RuleContext.h"
+#include "tree/ParseTreeRange.h"
+#include "tree/TerminalNode.h"
+#include "tree/pattern/ParseTreePattern.h"
+#include "tree/pattern/ParseTreePatternMatcher.h"
+#include "tree/pattern/RuleTagToken.h"
+
+#include "tree/pattern/ParseTreePatternSet.h"
+
+using namespace antlr4;
+using namespace antlr4::tree;
+using namespace antlr4::tree::pattern;
+
+ParseTreePatternSet::ParseTreePatternSet(ParseTreePatternMatcher *matcher) : _matcher(matcher) {
+}
+
+ParseTreePatternSet::~ParseTreePatternSet() {
+}
+
+size_t ParseTreePatternSet::add(const std::string &pattern, int patternRuleIndex) {
+  return add(_matcher->compile(pattern, patternRuleIndex));
+}
+
+size_t ParseTreePatternSet::add(const ParseTreePattern &pattern) {
+  if (pattern.getPatternRuleIndex() < 0) {
+    throw IllegalArgumentException("invalid pattern rule index");
+  }
+
+  // A pattern consisting of a rule tag only (like <expr>) matches any context of its rule.
+  ParseTree *patternTree = pattern.getPatternTree();
+  size_t childCount = patternTree->children.size();
+  if (childCount == 1 && patternTree->children[0]->getTreeType() != ParseTreeType::RULE &&
+      dynamic_cast<RuleTagToken *>(static_cast<TerminalNode *>(patternTree->children[0])->getSymbol()) != nullptr) {
+    childCount = INVALID_INDEX;
+  }
+
+  size_t id = _patterns.size();
+  _patterns.push_back({ std::unique_ptr<ParseTreePattern>(new ParseTreePattern(pattern)), childCount });
+
+  size_t ruleIndex = static_cast<size_t>(pattern.getPatternRuleIndex());
+  if (ruleIndex >= _patternsByRule.size()) {
+    _patternsByRule.resize(ruleIndex + 1);
+  }
+  _patternsByRule[ruleIndex].push_back(id);
+
+  return id;
+}
+
+size_t ParseTreePatternSet::size() const {
+  return _patterns.size();
+}
+
+const ParseTreePattern& ParseTreePatternSet::getPattern(size_t patternId) const {
+  return *_patterns[patternId].pattern;
+}
+
+void ParseTreePatternSet::findAll(ParseTree *tree, const MatchCallback &callback) const {
+  for (ParseTree *node : ParseTreeRange(tree).rules()) {
+    size_t ruleIndex = node->getRuleIndexOrTokenType();
+    if (ruleIndex >= _patternsByRule.size()) {
+      continue;
+    }
+
+    for (size_t id : _patternsByRule[ruleIndex]) {
+      const Entry &entry = _patterns[id];
+      if (entry.childCount != INVALID_INDEX && entry.childCount != node->children.size()) {
+        continue;
+      }
+
+      ParseTreeMatch match = _matcher->match(node, *entry.pattern);
+      if (match.succeeded()) {
+        callback(id, match);
+      }
+    }
+  }
+}
+
+std::vector<std::vector<ParseTreeMatch>> ParseTreePatternSet::findAll(ParseTree *tree) const {
+  std::vector<std::vector<ParseTreeMatch>> result(_patterns.size());
+  findAll(tree, [&result](size_t patternId, const ParseTreeMatch &match) {
+    result[patternId].push_back(match);
+  });
+  return result;
+}
@@ -0,0 +1,64 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "tree/pattern/ParseTreeMatch.h"
+
+namespace antlr4 {
+namespace tree {
+namespace pattern {
+
+  /// A set of compiled tree patterns, which are all matched against a parse tree in a single traversal.
+  /// Each pattern is compiled only once, when it is added.
+  ///
+  /// A pattern is only tried at the rule contexts of its pattern rule, so findAll() finds the same matches
+  /// as calling ParseTreePattern::findAll(tree, "//rule") for every pattern. The patterns are grouped by
+  /// rule index and patterns which cannot match a node (because it has a different number of children)
+  /// are skipped without running the matcher.
+  class ANTLR4CPP_PUBLIC ParseTreePatternSet {
+  public:
+    /// Called for each successful match, with the id of the matching pattern.
+    typedef std::function<void (size_t patternId, const ParseTreeMatch &match)> MatchCallback;
+
+    /// The matcher is used to compile and match the patterns and must outlive this set.
+    ParseTreePatternSet(ParseTreePatternMatcher *matcher);
+    ParseTreePatternSet(ParseTreePatternSet const&) = delete;
+    virtual ~ParseTreePatternSet();
+
+    ParseTreePatternSet& operator=(ParseTreePatternSet const&) = delete;
+
+    /// Compiles the pattern and adds it to the set. Returns the id of the new pattern, which is the number
+    /// of patterns added before it.
+    size_t add(const std::string &pattern, int patternRuleIndex);
+
+    /// Adds a pattern compiled by the matcher of this set. Returns the id of the new pattern.
+    size_t add(const ParseTreePattern &pattern);
+
+    size_t size() const;
+    const ParseTreePattern& getPattern(size_t patternId) const;
+
+    /// Matches all patterns against all subtrees of tree. Matches are reported in tree order (pre-order)
+    /// and, for the same node, in the order the patterns were added.
+    void findAll(ParseTree *tree, const MatchCallback &callback) const;
+
+    /// Returns the successful matches of all patterns, indexed by pattern id.
+    std::vector<std::vector<ParseTreeMatch>> findAll(ParseTree *tree) const;
+
+  private:
+    struct Entry {
+      // ParseTreeMatch refers to its pattern, so its address must not change.
+      std::unique_ptr<ParseTreePattern> pattern;
+      size_t childCount; // INVALID_INDEX if the pattern is a single rule tag.
+    };
+
+    ParseTreePatternMatcher *_matcher;
+    std::vector<Entry> _patterns;
+    std::vector<std::vector<size_t>> _patternsByRule; // Pattern ids, indexed by pattern rule index.
+  };
+
+} // namespace pattern
+} // namespace tree
+} // namespace antlr4
@@ -5,13 +5,7 @@
 
 #include "XPathLexer.h"
 #include "XPathLexerErrorListener.h"
-#include "XPathElement.h"
-#include "XPathWildcardAnywhereElement.h"
-#include "XPathWildcardElement.h"
-#include "XPathTokenAnywhereElement.h"
-#include "XPathTokenElement.h"
-#include "XPathRuleAnywhereElement.h"
-#include "XPathRuleElement.h"
+#include "XPathIndex.h"
 
 #include "XPath.h"
 
@@ -22,14 +16,27 @@ using namespace antlr4::tree::xpath;
 const std::string XPath::WILDCARD = "*";
 const std::string XPath::NOT = "!";
 
-XPath::XPath(Parser *parser, const std::string &path) {
-  _parser = parser;
-  _path = path;
-  _elements = split(path);
+XPath::XPath(Parser *parser, const std::string &path) : _path(path), _childSteps(0), _anywhereSteps(0) {
+  _steps = compile(parser, path);
+  for (size_t i = 0; i < _steps.size(); ++i) {
+    if (_steps[i].anywhere) {
+      _anywhereSteps |= uint64_t(1) << i;
+    } else {
+      _childSteps |= uint64_t(1) << i;
+    }
+  }
+}
+
+std::vector<ParseTree *> XPath::findAll(ParseTree *tree, const std::string &xpath, Parser *parser) {
+  return XPath(parser, xpath).evaluate(tree);
 }
 
-std::vector<XPathElement> XPath::split(const std::string &path) {
-  ANTLRFileStream in(path);
+const std::string& XPath::getPath() const {
+  return _path;
+}
+
+std::vector<XPath::Step> XPath::compile(Parser *parser, const std::string &path) {
+  ANTLRInputStream in(path);
   XPathLexer lexer(&in);
   lexer.removeErrorListeners();
   XPathLexerErrorListener listener;
@@ -44,7 +51,7 @@ std::vector<XPathElement> XPath::split(const std::string &path) {
   }
 
   std::vector<Token *> tokens = tokenStream.getTokens();
-  std::vector<XPathElement> elements;
+  std::vector<Step> steps;
   size_t n = tokens.size();
   size_t i = 0;
   bool done = false;
@@ -62,9 +69,7 @@ std::vector<XPathElement> XPath::split(const std::string &path) {
           i++;
           next = tokens[i];
         }
-        XPathElement pathElement = getXPathElement(next, anywhere);
-        pathElement.setInvert(invert);
-        elements.push_back(pathElement);
+        steps.push_back(getStep(parser, next, anywhere, invert));
         i++;
         break;
 
@@ -72,7 +77,7 @@ std::vector<XPathElement> XPath::split(const std::string &path) {
       case XPathLexer::TOKEN_REF:
       case XPathLexer::RULE_REF:
       case XPathLexer::WILDCARD:
-        elements.push_back(getXPathElement(el, false));
+        steps.push_back(getStep(parser, el, false, false));
         i++;
         break;
 
@@ -85,63 +90,211 @@ std::vector<XPathElement> XPath::split(const std::string &path) {
     }
   }
 
-  return elements;
+  if (steps.size() > MAX_STEPS) {
+    throw IllegalArgumentException("Too many elements in path '" + path + "'");
+  }
+  return steps;
 }
 
-XPathElement XPath::getXPathElement(Token *wordToken, bool anywhere) {
+XPath::Step XPath::getStep(Parser *parser, Token *wordToken, bool anywhere, bool invert) {
   if (wordToken->getType() == Token::EOF) {
     throw IllegalArgumentException("Missing path element at end of path");
   }
   std::string word = wordToken->getText();
-  size_t ttype = _parser->getTokenType(word);
-  ssize_t ruleIndex = _parser->getRuleIndex(word);
   switch (wordToken->getType()) {
     case XPathLexer::WILDCARD :
-      if (anywhere)
-        return XPathWildcardAnywhereElement();
-      return XPathWildcardElement();
+      return { StepKind::WILDCARD, 0, anywhere, invert };
 
     case XPathLexer::TOKEN_REF:
-    case XPathLexer::STRING :
+    case XPathLexer::STRING : {
+      size_t ttype = parser->getTokenType(word);
       if (ttype == Token::INVALID_TYPE) {
         throw IllegalArgumentException(word + " at index " + std::to_string(wordToken->getStartIndex()) + " isn't a valid token name");
       }
-      if (anywhere)
-        return XPathTokenAnywhereElement(word, (int)ttype);
-      return XPathTokenElement(word, (int)ttype);
+      return { StepKind::TOKEN, ttype, anywhere, invert };
+    }
 
-    default :
-      if (ruleIndex == -1) {
+    default : {
+      size_t ruleIndex = parser->getRuleIndex(word);
+      if (ruleIndex == INVALID_INDEX) {
         throw IllegalArgumentException(word + " at index " + std::to_string(wordToken->getStartIndex()) + " isn't a valid rule name");
       }
-      if (anywhere)
-        return XPathRuleAnywhereElement(word, (int)ruleIndex);
-      return XPathRuleElement(word, (int)ruleIndex);
+      return { StepKind::RULE, ruleIndex, anywhere, invert };
+    }
   }
 }
 
-static ParserRuleContext dummyRoot;
+bool XPath::Step::matches(ParseTree *node) const {
+  switch (kind) {
+    case StepKind::RULE:
+      return node->getTreeType() == ParseTreeType::RULE && (node->getRuleIndexOrTokenType() == index) != invert;
 
-std::vector<ParseTree *> XPath::evaluate(ParseTree *t) {
-  dummyRoot.children = { t }; // don't set t's parent.
+    case StepKind::TOKEN:
+      return node->getTreeType() != ParseTreeType::RULE && (node->getRuleIndexOrTokenType() == index) != invert;
 
-  std::vector<ParseTree *> work = { &dummyRoot };
+    default:
+      return !invert; // !* is weird but valid (empty)
+  }
+}
 
-  size_t i = 0;
-  while (i < _elements.size()) {
-    std::vector<ParseTree *> next;
-    for (auto node : work) {
-      if (!node->children.empty()) {
-        // only try to match next element if it has children
-        // e.g., //func/*/stat might have a token node for which
-        // we can't go looking for stat nodes.
-        auto matching = _elements[i].evaluate(node);
-        next.insert(next.end(), matching.begin(), matching.end());
+std::vector<ParseTree *> XPath::evaluate(ParseTree *t) const {
+  std::vector<ParseTree *> result;
+  evaluate(t, result);
+  return result;
+}
+
+void XPath::evaluate(ParseTree *t, std::vector<ParseTree *> &result) const {
+  if (_steps.empty()) {
+    return;
+  }
+
+  // For each node we know which steps it can match: those preceded by / whose previous step was matched
+  // by the parent (reach), and those preceded by // whose previous step was matched by an ancestor (active).
+  // Step 0 is relative to the (imaginary) parent of t.
+  struct Frame {
+    ParseTree *node;
+    size_t nextChild;
+    uint64_t childReach;
+    uint64_t childActive;
+  };
+
+  uint64_t last = uint64_t(1) << (_steps.size() - 1);
+  uint64_t reach = _childSteps & 1;
+  uint64_t active = _anywhereSteps & 1;
+  std::vector<Frame> stack;
+  ParseTree *node = t;
+  while (node != nullptr) {
+    uint64_t candidates = reach | active;
+    uint64_t matched = 0;
+    if (candidates != 0) {
+      // A node with children can also match a // step itself, if it matched the step before.
+      bool hasChildren = !node->children.empty();
+      for (size_t i = 0; i < _steps.size(); ++i) {
+        uint64_t bit = uint64_t(1) << i;
+        bool candidate = (candidates & bit) != 0 || (hasChildren && (_anywhereSteps & bit) != 0 && (matched & (bit >> 1)) != 0);
+        if (candidate && _steps[i].matches(node)) {
+          matched |= bit;
+        }
       }
     }
-    i++;
-    work = next;
+
+    if ((matched & last) != 0) {
+      result.push_back(node);
+    }
+
+    uint64_t childReach = _childSteps & (matched << 1);
+    uint64_t childActive = active | (_anywhereSteps & (matched << 1));
+    if ((childReach | childActive) != 0 && !node->children.empty()) {
+      stack.push_back({ node, 0, childReach, childActive });
+    }
+
+    node = nullptr;
+    while (!stack.empty()) {
+      Frame &frame = stack.back();
+      if (frame.nextChild < frame.node->children.size()) {
+        node = frame.node->children[frame.nextChild++];
+        reach = frame.childReach;
+        active = frame.childActive;
+        break;
+      }
+      stack.pop_back();
+    }
+  }
+}
+
+std::vector<ParseTree *> XPath::evaluate(ParseTree *t, const XPathIndex &index) const {
+  std::vector<ParseTree *> result;
+  evaluate(t, index, result);
+  return result;
+}
+
+void XPath::evaluate(ParseTree *t, const XPathIndex &index, std::vector<ParseTree *> &result) const {
+  if (_steps.empty()) {
+    return;
   }
 
-  return work;
+  const Step &last = _steps.back();
+  if (last.invert || last.kind == StepKind::WILDCARD) {
+    evaluate(t, result);
+    return;
+  }
+
+  const std::vector<ParseTree *> &candidates = last.kind == StepKind::RULE ? index.getRuleNodes(last.index)
+    : index.getTokenNodes(last.index);
+  // Without {@code //} after the first step each check only walks up once per step.
+  UpwardMatchCache cache;
+  UpwardMatchCache *usedCache = (_anywhereSteps >> 1) != 0 ? &cache : nullptr;
+  for (auto node : candidates) {
+    if (matchesUpwards(node, _steps.size() - 1, t, usedCache)) {
+      result.push_back(node);
+    }
+  }
+}
+
+bool XPath::matchesUpwards(ParseTree *node, size_t step, ParseTree *root, UpwardMatchCache *cache) const {
+  if (step == 0) {
+    if (!_steps[0].anywhere) {
+      return node == root;
+    }
+    if (root->parent == nullptr) { // All indexed nodes are in the tree of root.
+      return true;
+    }
+    for (ParseTree *p = node; p != nullptr; p = p->parent) {
+      if (p == root) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const Step &previous = _steps[step - 1];
+  if (!_steps[step].anywhere) {
+    if (node == root || node->parent == nullptr) {
+      return false;
+    }
+    return previous.matches(node->parent) && matchesAncestor(node->parent, step - 1, root, cache);
+  }
+
+  for (ParseTree *p = node; p != nullptr; p = p->parent) {
+    if ((p != node || !p->children.empty()) && previous.matches(p) && matchesAncestor(p, step - 1, root, cache)) {
+      return true;
+    }
+    if (p == root) {
+      break;
+    }
+  }
+  return false;
+}
+
+bool XPath::matchesAncestor(ParseTree *node, size_t step, ParseTree *root, UpwardMatchCache *cache) const {
+  if (cache == nullptr || step == 0) {
+    return matchesUpwards(node, step, root, cache);
+  }
+
+  uint64_t bit = uint64_t(1) << step;
+  const UpwardMatches &cached = cache->get(node);
+  if ((cached.known & bit) != 0) {
+    return (cached.matched & bit) != 0;
+  }
+
+  bool result = matchesUpwards(node, step, root, cache);
+
+  // The recursion may have moved the entry.
+  UpwardMatches &entry = cache->get(node);
+  entry.known |= bit;
+  if (result) {
+    entry.matched |= bit;
+  }
+  return result;
+}
+
+XPath::UpwardMatches& XPath::UpwardMatchCache::get(ParseTree *node) {
+  size_t ordinal = node->getOrdinal();
+  if (ordinal == INVALID_INDEX) {
+    return _others[node];
+  }
+  if (ordinal >= _byOrdinal.size()) {
+    _byOrdinal.resize(ordinal + 1);
+  }
+  return _byOrdinal[ordinal];
 }
@@ -15,9 +15,13 @@ namespace xpath {
   /// parse trees.
   ///
   /// <para>
-  /// Split path into words and separators {@code /} and {@code //} via ANTLR
-  /// itself then walk path elements from left to right. At each separator-word
-  /// pair, find set of nodes. Next stage uses those as work list.</para>
+  /// The constructor splits the path into words and separators {@code /} and {@code //}
+  /// via ANTLR itself and compiles them into a list of steps, once. A compiled XPath
+  /// can be evaluated against any number of trees, also from several threads at the
+  /// same time. Evaluation is a single traversal of the tree, which tracks for each
+  /// node the steps matched on the way down to it. With an XPathIndex of the tree the
+  /// candidates for the last step are taken from the index instead and checked by
+  /// walking up to the root.</para>
   ///
   /// <para>
   /// The basic interface is
@@ -58,26 +62,86 @@ namespace xpath {
     static const std::string WILDCARD; // word not operator/separator
     static const std::string NOT; // word for invert operator
 
+    /// The maximum number of path elements.
+    static const size_t MAX_STEPS = 64;
+
+    /// Throws IllegalArgumentException for invalid paths or unknown token and rule names.
     XPath(Parser *parser, const std::string &path);
     virtual ~XPath() {}
 
-    // TO_DO: check for invalid token/rule names, bad syntax
-    virtual std::vector<XPathElement> split(const std::string &path);
+    static std::vector<ParseTree *> findAll(ParseTree *tree, const std::string &xpath, Parser *parser);
+
+    const std::string& getPath() const;
 
     /// Return a list of all nodes starting at {@code t} as root that satisfy the
     /// path. The root {@code /} is relative to the node passed to
-    /// <seealso cref="#evaluate"/>.
-    virtual std::vector<ParseTree *> evaluate(ParseTree *t);
+    /// <seealso cref="#evaluate"/>. The nodes are returned in tree order (pre-order),
+    /// each node once.
+    std::vector<ParseTree *> evaluate(ParseTree *t) const;
+
+    /// Appends all nodes matching the path to result, which allows to reuse its memory.
+    void evaluate(ParseTree *t, std::vector<ParseTree *> &result) const;
+
+    /// Same as evaluate(t), but uses the index for paths whose last element is a token
+    /// or rule name (without {@code !}). {@code t} must be part of the indexed tree.
+    std::vector<ParseTree *> evaluate(ParseTree *t, const XPathIndex &index) const;
+    void evaluate(ParseTree *t, const XPathIndex &index, std::vector<ParseTree *> &result) const;
 
   protected:
+    enum class StepKind {
+      RULE,
+      TOKEN,
+      WILDCARD
+    };
+
+    /// A compiled path element.
+    struct Step {
+      StepKind kind;
+      size_t index; // The rule index or token type.
+      bool anywhere; // Preceded by {@code //}.
+      bool invert;
+
+      bool matches(ParseTree *node) const;
+    };
+
     std::string _path;
-    std::vector<XPathElement> _elements;
-    Parser *_parser;
+    std::vector<Step> _steps;
+
+    // Bit i is set if step i is preceded by {@code /} or {@code //}, respectively.
+    uint64_t _childSteps;
+    uint64_t _anywhereSteps;
+
+  private:
+    std::vector<Step> compile(Parser *parser, const std::string &path);
 
     /// Convert word like {@code *} or {@code ID} or {@code expr} to a path
-    /// element. {@code anywhere} is {@code true} if {@code //} precedes the
+    /// step. {@code anywhere} is {@code true} if {@code //} precedes the
     /// word.
-    virtual XPathElement getXPathElement(Token *wordToken, bool anywhere);
+    Step getStep(Parser *parser, Token *wordToken, bool anywhere, bool invert);
+
+    /// Bit i is set in known if it was checked whether an ancestor matches the steps up to i, and in
+    /// matched if it does. Candidates share most of their ancestors, so with several {@code //} steps
+    /// the same ancestor would be checked over and over again.
+    struct UpwardMatches {
+      uint64_t known;
+      uint64_t matched;
+    };
+
+    /// Stores the UpwardMatches by node ordinal (like DenseParseTreeProperty), as ancestors are created
+    /// before their descendants and have small ordinals. Nodes without ordinal are kept in a map.
+    class UpwardMatchCache {
+    public:
+      UpwardMatches& get(ParseTree *node);
+
+    private:
+      std::vector<UpwardMatches> _byOrdinal;
+      std::unordered_map<ParseTree *, UpwardMatches> _others;
+    };
+
+    /// Checks if the node, which matches the given step, has ancestors (up to root) which match the
+    /// steps before. The cache is optional.
+    bool matchesUpwards(ParseTree *node, size_t step, ParseTree *root, UpwardMatchCache *cache) const;
+    bool matchesAncestor(ParseTree *node, size_t step, ParseTree *root, UpwardMatchCache *cache) const;
   };
 
 } // namespace xpath
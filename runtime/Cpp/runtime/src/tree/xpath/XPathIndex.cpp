@@ -0,0 +1,54 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "RuleContext.h"
+#include "Token.h"
+#include "tree/ParseTreeRange.h"
+#include "tree/TerminalNode.h"
+
+#include "tree/xpath/XPathIndex.h"
+
+using namespace antlr4;
+using namespace antlr4::tree;
+using namespace antlr4::tree::xpath;
+
+namespace {
+
+  const std::vector<ParseTree *> noNodes;
+
+  void add(std::vector<std::vector<ParseTree *>> &lists, size_t index, ParseTree *node) {
+    if (index >= lists.size()) {
+      lists.resize(index + 1);
+    }
+    lists[index].push_back(node);
+  }
+
+}
+
+XPathIndex::XPathIndex(ParseTree *root) : _root(root) {
+  for (ParseTree *node : ParseTreeRange(root)) {
+    size_t value = node->getRuleIndexOrTokenType();
+    if (node->getTreeType() == ParseTreeType::RULE) {
+      if (value != INVALID_INDEX) {
+        add(_ruleNodes, value, node);
+      }
+    } else {
+      add(_tokenNodes, value + 1, node);
+    }
+  }
+}
+
+ParseTree* XPathIndex::getRoot() const {
+  return _root;
+}
+
+const std::vector<ParseTree *>& XPathIndex::getRuleNodes(size_t ruleIndex) const {
+  return ruleIndex < _ruleNodes.size() ? _ruleNodes[ruleIndex] : noNodes;
+}
+
+const std::vector<ParseTree *>& XPathIndex::getTokenNodes(size_t tokenType) const {
+  size_t index = tokenType + 1;
+  return index < _tokenNodes.size() ? _tokenNodes[index] : noNodes;
+}
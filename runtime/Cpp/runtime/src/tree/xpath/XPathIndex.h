@@ -0,0 +1,40 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace tree {
+namespace xpath {
+
+  /// Lists the nodes of a parse tree by rule index and token type, in tree order (pre-order).
+  /// Built once per tree, it lets XPath queries start from the nodes which can match their
+  /// last path element, instead of traversing the whole tree. Terminal and error nodes are
+  /// both listed by token type.
+  ///
+  /// The index doesn't follow changes of the tree. It can be used by several threads at the same time.
+  class ANTLR4CPP_PUBLIC XPathIndex {
+  public:
+    XPathIndex(ParseTree *root);
+
+    ParseTree* getRoot() const;
+
+    /// All rule contexts with the given rule index.
+    const std::vector<ParseTree *>& getRuleNodes(size_t ruleIndex) const;
+
+    /// All terminal and error nodes with the given token type (which may be Token::EOF).
+    const std::vector<ParseTree *>& getTokenNodes(size_t tokenType) const;
+
+  private:
+    ParseTree *_root;
+    std::vector<std::vector<ParseTree *>> _ruleNodes;
+    std::vector<std::vector<ParseTree *>> _tokenNodes; // Indexed by token type + 1, to include EOF.
+  };
+
+} // namespace xpath
+} // namespace tree
+} // namespace antlr4
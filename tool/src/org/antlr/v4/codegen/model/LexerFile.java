@@ -15,6 +15,8 @@ public class LexerFile extends OutputFile {
 	public String exportMacro; // from -DexportMacro cmd-line
 	public boolean genListener; // from -listener cmd-line
 	public boolean genVisitor; // from -visitor cmd-line
+	public boolean exceptionFree; // from -DexceptionFree=true cmd-line
+	public boolean staticATN; // from -DstaticATN=true cmd-line
 	@ModelElement public Lexer lexer;
 	@ModelElement public Map<String, Action> namedActions;
 
@@ -25,5 +27,7 @@ public class LexerFile extends OutputFile {
 		exportMacro = factory.getGrammar().getOptionString("exportMacro");
 		genListener = factory.getGrammar().tool.gen_listener;
 		genVisitor = factory.getGrammar().tool.gen_visitor;
+		exceptionFree = "true".equals(factory.getGrammar().getOptionString("exceptionFree"));
+		staticATN = "true".equals(factory.getGrammar().getOptionString("staticATN"));
 	}
 }
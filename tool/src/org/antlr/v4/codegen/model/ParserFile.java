@@ -19,6 +19,10 @@ public class ParserFile extends OutputFile {
 	public String exportMacro; // from -DexportMacro cmd-line
 	public boolean genListener; // from -listener cmd-line
 	public boolean genVisitor; // from -visitor cmd-line
+	public boolean typedVisitor; // from -DtypedVisitor=true cmd-line
+	public boolean incremental; // from -Dincremental=true cmd-line
+	public boolean exceptionFree; // from -DexceptionFree=true cmd-line
+	public boolean staticATN; // from -DstaticATN=true cmd-line
 	@ModelElement public Parser parser;
 	@ModelElement public Map<String, Action> namedActions;
 	@ModelElement public ActionChunk contextSuperClass;
@@ -33,6 +37,10 @@ public class ParserFile extends OutputFile {
 		// need the below members in the ST for Python, C++
 		genListener = g.tool.gen_listener;
 		genVisitor = g.tool.gen_visitor;
+		typedVisitor = "true".equals(g.getOptionString("typedVisitor"));
+		incremental = "true".equals(g.getOptionString("incremental"));
+		exceptionFree = "true".equals(g.getOptionString("exceptionFree"));
+		staticATN = "true".equals(g.getOptionString("staticATN"));
 		grammarName = g.name;
 
 		if (g.getOptionString("contextSuperClass") != null) {
@@ -22,6 +22,7 @@ public class VisitorFile extends OutputFile {
 	public String genPackage; // from -package cmd-line
 	public String accessLevel; // from -DaccessLevel cmd-line
 	public String exportMacro; // from -DexportMacro cmd-line
+	public boolean typedVisitor; // from -DtypedVisitor=true cmd-line
 	public String grammarName;
 	public String parserName;
 	/**
@@ -62,5 +63,6 @@ public class VisitorFile extends OutputFile {
 		genPackage = g.tool.genPackage;
 		accessLevel = g.getOptionString("accessLevel");
 		exportMacro = g.getOptionString("exportMacro");
+		typedVisitor = "true".equals(g.getOptionString("typedVisitor"));
 	}
 }
@@ -83,6 +83,10 @@ public class Grammar implements AttributeResolver {
 		parserOptions.add("language");
 		parserOptions.add("accessLevel");
 		parserOptions.add("exportMacro");
+		parserOptions.add("typedVisitor");
+		parserOptions.add("incremental");
+		parserOptions.add("exceptionFree");
+		parserOptions.add("staticATN");
 	}
 
 	public static final Set<String> lexerOptions = parserOptions;